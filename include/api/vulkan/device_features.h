@@ -128,7 +128,10 @@ namespace rend
        VULKAN_MEMORY_MODEL_AVAILABILITY_VISIBILITY_CHAINS,
        SHADER_OUTPUT_VIEWPORT_INDEX,
        SHADER_OUTPUT_LAYER,
-       SUBGROUP_BROADCAST_DYNAMIC_ID
+       SUBGROUP_BROADCAST_DYNAMIC_ID,
+
+       // Since Vulkan 1.3
+       SYNCHRONIZATION_2
     };
 
     struct PhysicalDeviceFeatures
@@ -136,6 +139,7 @@ namespace rend
         VkPhysicalDeviceFeatures vk_1_0_features;
         VkPhysicalDeviceVulkan11Features vk_1_1_features;
         VkPhysicalDeviceVulkan12Features vk_1_2_features;
+        VkPhysicalDeviceVulkan13Features vk_1_3_features;
 
         static PhysicalDeviceFeatures make_device_features(const std::vector<DeviceFeature>& features);
     };
@@ -5,6 +5,7 @@
 
 #include "api/vulkan/device_features.h"
 #include "api/vulkan/queue_family.h"
+#include "api/vulkan/timeline_semaphore.h"
 
 #include <vulkan.h>
 #include <vector>
@@ -36,21 +37,23 @@ public:
     const QueueFamily*    get_queue_family(QueueType type) const;
 
     // Commands
-    bool                         queue_submit(VkCommandBuffer* command_buffers, uint32_t command_buffers_count, QueueType type, const std::vector<Semaphore*>& wait_sems, const std::vector<Semaphore*>& signal_sems, const Fence* fence);
+    bool                         queue_submit(VkCommandBuffer* command_buffers, uint32_t command_buffers_count, QueueType type, const std::vector<Semaphore*>& wait_sems, const std::vector<Semaphore*>& signal_sems, const std::vector<TimelinePoint>& timeline_waits, const std::vector<TimelinePoint>& timeline_signals, const Fence* fence);
     uint32_t                     find_memory_type(uint32_t desired_type, VkMemoryPropertyFlags memory_properties);
     void                         wait_idle(void);
     VkResult                     wait_for_fences(std::vector<VkFence>& fences, uint64_t timeout, bool wait_all);
     void                         reset_fences(std::vector<VkFence>& fences);
+    VkResult                     wait_semaphore(VkSemaphore semaphore, uint64_t value, uint64_t timeout);
+    uint64_t                     get_semaphore_counter_value(VkSemaphore semaphore);
 
     VkResult                     acquire_next_image(Swapchain* swapchain, uint64_t timeout, Semaphore* semaphore, Fence* fence, uint32_t* image_index);
     VkResult                     queue_present(QueueType type, const std::vector<Semaphore*>& wait_sems, const std::vector<Swapchain*>& swapchains, const std::vector<uint32_t>& image_indices, std::vector<VkResult>& results);
     VkResult                     get_swapchain_images(VkSwapchainKHR swapchain, std::vector<VkImage>& images);
 
     VkMemoryRequirements         get_buffer_memory_reqs(VkBuffer buffer);
-    VkResult                     bind_buffer_memory(VkBuffer buffer, VkDeviceMemory memory);
+    VkResult                     bind_buffer_memory(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset);
 
     VkMemoryRequirements         get_image_memory_reqs(VkImage image);
-    VkResult                     bind_image_memory(VkImage image, VkDeviceMemory memory);
+    VkResult                     bind_image_memory(VkImage image, VkDeviceMemory memory, VkDeviceSize offset);
 
     std::vector<VkDescriptorSet> allocate_descriptor_sets(std::vector<VkDescriptorSetLayout>& layouts, VkDescriptorPool pool);
     void                         free_descriptor_sets(const VkDescriptorSet* sets, uint32_t sets_count, VkDescriptorPool pool);
@@ -63,6 +66,8 @@ public:
     void                  free_memory(VkDeviceMemory memory);
     bool                  map_memory(VkDeviceMemory memory, size_t size_bytes, uint64_t offset_bytes, void** mapped);
     void                  unmap_memory(VkDeviceMemory memory);
+    bool                  flush_memory(const VkMappedMemoryRange& range);
+    bool                  invalidate_memory(const VkMappedMemoryRange& range);
 
     VkSwapchainKHR        create_swapchain(VkSwapchainCreateInfoKHR& create_info);
     void                  destroy_swapchain(VkSwapchainKHR swapchain);
@@ -98,6 +103,10 @@ public:
     VkEvent               create_event(const VkEventCreateInfo& create_info);
     void                  destroy_event(VkEvent event);
 
+    VkQueryPool           create_query_pool(const VkQueryPoolCreateInfo& create_info);
+    void                  destroy_query_pool(VkQueryPool query_pool);
+    VkResult              get_query_pool_results(VkQueryPool query_pool, uint32_t first_query, uint32_t queries_count, size_t size_bytes, void* data, VkDeviceSize stride_bytes, VkQueryResultFlags flags);
+
     VkFence               create_fence(const VkFenceCreateInfo& create_info);
     void                  destroy_fence(VkFence fence);
 
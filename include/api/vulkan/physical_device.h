@@ -32,6 +32,7 @@ public:
     const std::vector<VkPresentModeKHR>&    get_surface_present_modes(void) const;
     VkSurfaceCapabilitiesKHR                get_surface_capabilities(const VulkanInstance& vk_instance) const;
     const VkPhysicalDeviceMemoryProperties& get_memory_properties(void) const;
+    const VkPhysicalDeviceProperties&       get_properties(void) const;
 
     bool has_features(const std::vector<DeviceFeature>& features) const;
     bool has_queues(VkQueueFlags queue_flags) const;
@@ -53,6 +54,7 @@ private:
     std::vector<QueueFamily>         _queue_families;
     std::vector<QueueFamily*>        _graphics_queue_families;
     std::vector<QueueFamily*>        _present_queue_families;
+    std::vector<QueueFamily*>        _transfer_queue_families;
 };
 
 }
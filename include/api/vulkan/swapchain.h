@@ -27,7 +27,7 @@ class VulkanTexture;
 class Swapchain
 {
 public:
-    explicit Swapchain(uint32_t desired_images, VulkanDeviceContext& ctx);
+    Swapchain(uint32_t desired_images, VkPresentModeKHR desired_present_mode, VulkanDeviceContext& ctx);
     ~Swapchain(void);
     Swapchain(const Swapchain&)            = delete;
     Swapchain(Swapchain&&)                 = delete;
@@ -53,13 +53,14 @@ private:
     void               _clean_up_images(void);
     StatusCode         _get_images(void);
     VkSurfaceFormatKHR _find_surface_format(const std::vector<VkSurfaceFormatKHR>& surface_formats);
-    VkPresentModeKHR   _find_present_mode(const std::vector<VkPresentModeKHR>& present_modes);
+    VkPresentModeKHR   _find_present_mode(VkPresentModeKHR desired_present_mode, const std::vector<VkPresentModeKHR>& present_modes);
     uint32_t           _find_image_count(uint32_t desired_images, const VkSurfaceCapabilitiesKHR& surface_caps);
     TextureHandle      _register_swapchain_image(const std::string& name, VkImage image);
     void               _unregister_swapchain_image(TextureHandle texture_handle);
 
 private:
     uint32_t             _desired_image_count { 0 };
+    VkPresentModeKHR     _desired_present_mode { VK_PRESENT_MODE_FIFO_KHR };
     uint32_t             _image_idx { 0 };
     uint32_t             _create_count{ 0 };
     VkSurfaceFormatKHR   _surface_format {};
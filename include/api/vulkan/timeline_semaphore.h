@@ -0,0 +1,48 @@
+#ifndef REND_API_VULKAN_TIMELINE_SEMAPHORE_H
+#define REND_API_VULKAN_TIMELINE_SEMAPHORE_H
+
+#include "core/rend_defs.h"
+
+#include <limits>
+#include <string>
+#include <vulkan.h>
+
+namespace rend
+{
+
+class TimelineSemaphore;
+class VulkanDeviceContext;
+
+// A value of a timeline semaphore for a submission to wait for or signal
+struct TimelinePoint
+{
+    TimelineSemaphore*   semaphore{ nullptr };
+    uint64_t             value{ 0 };
+    VkPipelineStageFlags wait_stages{ VK_PIPELINE_STAGE_ALL_COMMANDS_BIT }; // Only used when waiting
+};
+
+// Semaphore holding a 64 bit counter that only ever increases. Submissions signal it to a value once their work
+// completes, so one semaphore can track every submission and the CPU can wait for, or poll, any of them.
+class TimelineSemaphore
+{
+public:
+    TimelineSemaphore(const std::string& name, uint64_t initial_value, VulkanDeviceContext& ctx);
+    ~TimelineSemaphore(void);
+    TimelineSemaphore(const TimelineSemaphore&)            = delete;
+    TimelineSemaphore(TimelineSemaphore&&)                 = delete;
+    TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+    TimelineSemaphore& operator=(TimelineSemaphore&&)      = delete;
+
+    VkSemaphore vk_handle(void) const;
+    uint64_t    get_value(void) const;
+    VkResult    wait(uint64_t value, uint64_t timeout=std::numeric_limits<uint64_t>::max()) const;
+
+private:
+    VkSemaphore          _vk_semaphore{ VK_NULL_HANDLE };
+    std::string          _name;
+    VulkanDeviceContext* _ctx{ nullptr };
+};
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef REND_API_VULKAN_VULKAN_BARRIER_BATCH_H
+#define REND_API_VULKAN_VULKAN_BARRIER_BATCH_H
+
+#include <cstdint>
+#include <vector>
+#include <vulkan.h>
+
+namespace rend
+{
+
+class VulkanCommandBuffer;
+class VulkanTexture;
+
+// Moves a range of a texture's subresources to a new layout and use
+struct VulkanImageTransition
+{
+    VkImageLayout         layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+    VkPipelineStageFlags2 stages{ VK_PIPELINE_STAGE_2_NONE };
+    VkAccessFlags2        accesses{ VK_ACCESS_2_NONE };
+    uint32_t              base_mip{ 0 };
+    uint32_t              mips_count{ VK_REMAINING_MIP_LEVELS };
+    uint32_t              base_layer{ 0 };
+    uint32_t              layers_count{ VK_REMAINING_ARRAY_LAYERS };
+
+    // Work on the texture its tracked state did not see, e.g. reads that ran without a barrier
+    VkPipelineStageFlags2 src_stages{ VK_PIPELINE_STAGE_2_NONE };
+    VkAccessFlags2        src_accesses{ VK_ACCESS_2_NONE };
+
+    // The old contents are not needed, so transition from UNDEFINED
+    bool                  discard{ false };
+
+    // Set both to release the texture to another queue family, which then records the matching acquire
+    uint32_t              src_queue_family{ VK_QUEUE_FAMILY_IGNORED };
+    uint32_t              dst_queue_family{ VK_QUEUE_FAMILY_IGNORED };
+};
+
+// Accumulates barriers and records them with a single vkCmdPipelineBarrier2 on flush.
+// Texture transitions read and update the per subresource state VulkanTexture tracks. Neighbouring subresources
+// leaving the same state share one barrier, and adding readers to an unchanged layout needs no barrier at all.
+// Barriers in one flush are not ordered against each other, so transitioning subresources again before a flush
+// retargets their pending barriers instead of adding more.
+class VulkanBarrierBatch
+{
+public:
+    void transition(VulkanTexture& texture, const VulkanImageTransition& transition);
+
+    // Untracked barriers, e.g. queue family acquires
+    void barrier(const VkImageMemoryBarrier2& barrier);
+    void barrier(const VkBufferMemoryBarrier2& barrier);
+
+    void flush(VulkanCommandBuffer& command_buffer);
+    void clear(void);
+
+    [[nodiscard]] bool empty(void) const;
+
+private:
+    void _add_image_barrier(const VkImageMemoryBarrier2& barrier);
+    void _widen_pending_barrier(VkImage image, uint32_t mip, uint32_t layer, VkPipelineStageFlags2 stages, VkAccessFlags2 accesses);
+
+private:
+    std::vector<VkImageMemoryBarrier2>  _image_barriers;
+    std::vector<VkBufferMemoryBarrier2> _buffer_barriers;
+};
+
+}
+
+#endif
@@ -17,6 +17,9 @@ class VulkanBuffer : public GPUBuffer
 
         const VulkanBufferInfo& vk_buffer_info(void) const;
 
+        // Host visible buffers stay mapped for their lifetime, null otherwise
+        void* mapped(void) const;
+
     private:
         VulkanBufferInfo _vk_buffer_info{};
 };
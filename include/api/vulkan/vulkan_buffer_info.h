@@ -1,6 +1,8 @@
 #ifndef REND_API_VULKAN_VULKAN_BUFFER_INFO_H
 #define REND_API_VULKAN_VULKAN_BUFFER_INFO_H
 
+#include "api/vulkan/vulkan_memory_allocation.h"
+
 #include <vulkan.h>
 
 namespace rend
@@ -8,9 +10,9 @@ namespace rend
 
 struct VulkanBufferInfo
 {
-    VkBuffer       buffer{ VK_NULL_HANDLE };
-    VkDeviceMemory memory{ VK_NULL_HANDLE };
-    size_t         bytes{ 0 };
+    VkBuffer               buffer{ VK_NULL_HANDLE };
+    VulkanMemoryAllocation memory{};
+    size_t                 bytes{ 0 };
 };
 
 }
@@ -2,7 +2,10 @@
 #define REND_API_VULKAN_VULKAN_COMMAND_BUFFER_H
 
 #include "core/command_buffer.h"
+#include "core/rend_constants.h"
 
+#include <array>
+#include <span>
 #include <vector>
 #include <vulkan.h>
 
@@ -17,45 +20,95 @@ struct PerPassData;
 class Pipeline;
 class PipelineLayout;
 class RenderPass;
+class VulkanBarrierBatch;
+class VulkanPassQueries;
 
 class VulkanCommandBuffer : public CommandBuffer
 {
+    friend class VulkanCommandPool;
 
 public:
-    VulkanCommandBuffer(const std::string& name, VkCommandBuffer vk_handle);
+    VulkanCommandBuffer(const std::string& name, VkCommandBuffer vk_handle, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     ~VulkanCommandBuffer(void) = default;
 
     // Common functions
     CommandBufferState get_state(void) const override;
+    const CommandBufferStats& get_stats(void) const override;
     void reset(void) override;
-    void bind_descriptor_sets(PipelineBindPoint bind_point, const PipelineLayout& pipeline_layout, const std::vector<const DescriptorSet*> descriptor_sets) override;
+    void bind_descriptor_sets(PipelineBindPoint bind_point, const PipelineLayout& pipeline_layout, const std::vector<const DescriptorSet*>& descriptor_sets) override;
     void bind_pipeline(PipelineBindPoint bind_point, const Pipeline& pipeline) override;
-    void bind_vertex_buffer(const GPUBuffer& vertex_buffer) override;
-    void bind_index_buffer(const GPUBuffer& index_buffer) override;
+    void bind_vertex_buffer(const GPUBuffer& vertex_buffer, size_t offset = 0) override;
+    void bind_index_buffer(const GPUBuffer& index_buffer, size_t offset = 0) override;
     void blit(const GPUTexture& src, const GPUTexture& dst) override;
     void copy(const GPUBuffer& src, const GPUBuffer& dst, const BufferBufferCopyInfo& info) override;
     void copy(const GPUBuffer& src, const GPUTexture& dst, const BufferImageCopyInfo& info) override;
     void copy(const GPUTexture& src, const GPUTexture& dst, const ImageImageCopyInfo& info) override;
     void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override;
     void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) override;
+    void draw_indexed_indirect(const GPUBuffer& buffer, size_t offset, uint32_t draw_count, uint32_t stride) override;
+    void execute_commands(const std::vector<CommandBuffer*>& command_buffers) override;
     void push_constant(const PipelineLayout& layout, ShaderStages stages, uint32_t offset, size_t size, const void* data) override;
     void set_viewport(const std::vector<ViewportInfo>& viewports) override;
     void set_scissor(const std::vector<ViewportInfo>& scissors) override;
+    void begin_pass_query(const std::string& name, uint32_t subpasses_count) override;
+    void begin_subpass_query(const std::string& name, SubPassContents contents) override;
+    void end_pass_query(void) override;
 
     // Vulkan-specific
     VkCommandBuffer vk_handle(void) const;
+    VkCommandBufferLevel level(void) const;
     void transition_image(GPUTexture& texture, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout new_layout);
+    static void transition_image(VulkanBarrierBatch& barriers, GPUTexture& texture, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout new_layout);
     void transition_image(GPUTexture& texture, ImageLayout layout, uint32_t mips, uint32_t layers, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout new_layout);
     bool begin(void);
+    // Secondaries executed while a pipeline statistics query is active must inherit its statistics
+    bool begin(const RenderPass& render_pass, uint32_t subpass, const Framebuffer* framebuffer, VkQueryPipelineStatisticFlags pipeline_statistics = 0);
     void end(void);
-    void begin_render_pass(const RenderPass& render_pass, const PerPassData& per_pass_data);
+    void begin_render_pass(const RenderPass& render_pass, const PerPassData& per_pass_data, SubPassContents contents = SubPassContents::INLINE);
     void end_render_pass(void);
-    void next_subpass(void);
+    void next_subpass(SubPassContents contents = SubPassContents::INLINE);
     void pipeline_barrier(const PipelineBarrierInfo& info);
+    void pipeline_barrier(std::span<const VkBufferMemoryBarrier2> buffer_barriers, std::span<const VkImageMemoryBarrier2> image_barriers);
+    void reset_query_pool(VkQueryPool query_pool, uint32_t first_query, uint32_t queries_count);
+    void write_timestamp(VkPipelineStageFlags2 stage, VkQueryPool query_pool, uint32_t query);
+    void begin_query(VkQueryPool query_pool, uint32_t query);
+    void end_query(VkQueryPool query_pool, uint32_t query);
+    // Draw passes recorded from now on are timed with these, null stops timing
+    void set_pass_queries(VulkanPassQueries* pass_queries);
+
+private:
+    void _reset_bound_state(void);
 
 private:
     VkCommandBuffer _vk_handle{ VK_NULL_HANDLE };
+    VkCommandBufferLevel _level{ VK_COMMAND_BUFFER_LEVEL_PRIMARY };
     CommandBufferState _state{ CommandBufferState::INITIAL };
+    CommandBufferStats _stats{};
+    VulkanPassQueries* _pass_queries{ nullptr };
+
+    // Render pass instance being recorded, for timing its subpasses
+    const RenderPass*  _render_pass{ nullptr };
+    const Framebuffer* _framebuffer{ nullptr };
+    uint32_t           _subpass{ 0 };
+
+    // Shadow of the state bound by this command buffer, used to skip commands that change nothing
+    VkPipeline         _bound_pipeline{ VK_NULL_HANDLE };
+    VkPipelineLayout   _bound_descriptor_sets_layout{ VK_NULL_HANDLE };
+    std::array<VkDescriptorSet, constants::max_descriptor_sets> _bound_descriptor_sets{};
+    std::vector<uint32_t> _dynamic_offsets; // Gathered for each bind, kept to reuse its storage
+    VkBuffer           _bound_vertex_buffer{ VK_NULL_HANDLE };
+    VkDeviceSize       _bound_vertex_buffer_offset{ 0 };
+    VkBuffer           _bound_index_buffer{ VK_NULL_HANDLE };
+    VkDeviceSize       _bound_index_buffer_offset{ 0 };
+    std::array<VkViewport, constants::max_viewports> _bound_viewports{};
+    uint32_t           _bound_viewports_count{ 0 };
+    std::array<VkRect2D, constants::max_scissors> _bound_scissors{};
+    uint32_t           _bound_scissors_count{ 0 };
+    VkPipelineLayout   _pushed_constants_layout{ VK_NULL_HANDLE };
+    VkShaderStageFlags _pushed_constants_stages{ 0 };
+    uint32_t           _pushed_constants_offset{ 0 };
+    uint32_t           _pushed_constants_size{ 0 };
+    std::array<uint8_t, constants::max_push_constant_bytes> _pushed_constants{};
 };
 
 }
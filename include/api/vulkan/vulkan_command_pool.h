@@ -1,32 +1,48 @@
-//#ifndef REND_PI_VULKAN_VULKAN_COMMAND_POOL_H
-//#define REND_PI_VULKAN_VULKAN_COMMAND_POOL_H
-//
-//#include "core/command_buffer.h"
-//#include "core/containers/data_array.h"
-//
-//namespace rend
-//{
-//
-//class VulkanCommandPool
-//{
-//    public:
-//        CommandPool(void);
-//        ~CommandPool(void);
-//        CommandPool(const CommandPool&)            = delete;
-//        CommandPool(CommandPool&&)                 = delete;
-//        CommandPool& operator=(const CommandPool&) = delete;
-//        CommandPool& operator=(CommandPool&&)      = delete;
-//
-//        VkCommandPool handle(void) const;
-//
-//        CommandBuffer* create_command_buffer(void);
-//        void           destroy_command_buffer(CommandBuffer* command_buffer);
-//        void           reset(void);
-//
-//    private:
-//        VkCommandPool _handle{ VK_NULL_HANDLE };
-//};
-//
-//}
-//
-//#endif
+#ifndef REND_API_VULKAN_VULKAN_COMMAND_POOL_H
+#define REND_API_VULKAN_VULKAN_COMMAND_POOL_H
+
+#include "api/vulkan/queue_family.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan.h>
+
+namespace rend
+{
+
+class VulkanCommandBuffer;
+class VulkanDeviceContext;
+
+// Owns a VkCommandPool and every command buffer allocated from it. Buffers are
+// handed out linearly and recycled in bulk by reset(), so a pool must only be
+// used by one thread at a time and only reset once the GPU is done with it.
+class VulkanCommandPool
+{
+public:
+    VulkanCommandPool(const std::string& name, VulkanDeviceContext& device_context, QueueType queue);
+    ~VulkanCommandPool(void);
+    VulkanCommandPool(const VulkanCommandPool&)            = delete;
+    VulkanCommandPool(VulkanCommandPool&&)                 = delete;
+    VulkanCommandPool& operator=(const VulkanCommandPool&) = delete;
+    VulkanCommandPool& operator=(VulkanCommandPool&&)      = delete;
+
+    VkCommandPool vk_handle(void) const;
+
+    [[nodiscard]] VulkanCommandBuffer* acquire_command_buffer(VkCommandBufferLevel level);
+    void reset(void);
+
+private:
+    std::string          _name;
+    VulkanDeviceContext& _device_context;
+    VkCommandPool        _vk_handle{ VK_NULL_HANDLE };
+
+    std::vector<VulkanCommandBuffer*> _primary_command_buffers;
+    std::vector<VulkanCommandBuffer*> _secondary_command_buffers;
+    uint32_t _primary_command_buffers_used{ 0 };
+    uint32_t _secondary_command_buffers_used{ 0 };
+};
+
+}
+
+#endif
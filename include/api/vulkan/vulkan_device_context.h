@@ -5,6 +5,7 @@
 #include "core/containers/data_array.h"
 #include "api/vulkan/device_features.h"
 #include "api/vulkan/queue_family.h"
+#include "api/vulkan/timeline_semaphore.h"
 #include "api/vulkan/vulkan_buffer_info.h"
 #include "api/vulkan/vulkan_descriptor_set_info.h"
 #include "api/vulkan/vulkan_image_info.h"
@@ -25,6 +26,7 @@ class PhysicalDevice;
 class Semaphore;
 class VulkanCommandBuffer;
 class VulkanInstance;
+class VulkanMemoryAllocator;
 class Window;
 struct BufferInfo;
 struct DescriptorSetBinding;
@@ -49,10 +51,12 @@ public:
     PhysicalDevice*                     gpu(void) const;
     LogicalDevice*                      get_device(void) const;
     const VulkanInstance&               vulkan_instance(void) const;
+    bool                                has_feature(DeviceFeature feature) const; // Whether the feature was enabled
 
     [[nodiscard]] VulkanBufferInfo        create_buffer(const BufferInfo& info, VkMemoryPropertyFlags memory_properties);
-    [[nodiscard]] VkCommandBuffer         create_command_buffer(VkCommandPool command_pool);
+    [[nodiscard]] VkCommandBuffer         create_command_buffer(VkCommandPool command_pool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     [[nodiscard]] VkCommandPool           create_command_pool(void);
+    [[nodiscard]] VkCommandPool           create_command_pool(QueueType queue, VkCommandPoolCreateFlags flags);
     [[nodiscard]] VkDescriptorPool        create_descriptor_pool(const DescriptorPoolInfo& info);
     [[nodiscard]] VulkanDescriptorSetInfo create_descriptor_set(VkDescriptorPool pool, VkDescriptorSetLayout layout);
     [[nodiscard]] VkDescriptorSetLayout   create_descriptor_set_layout(const DescriptorSetLayoutInfo& info);
@@ -61,6 +65,7 @@ public:
     [[nodiscard]] VkFramebuffer           create_framebuffer(const FramebufferInfo& info);
     [[nodiscard]] VkPipeline              create_pipeline(const PipelineInfo& info);
     [[nodiscard]] VkPipelineLayout        create_pipeline_layout(const PipelineLayoutInfo& info);
+    [[nodiscard]] VkQueryPool             create_query_pool(const VkQueryPoolCreateInfo& info);
     [[nodiscard]] VkRenderPass            create_render_pass(const RenderPassInfo& info);
     [[nodiscard]] VkSemaphore             create_semaphore(const VkSemaphoreCreateInfo& info);
     [[nodiscard]] VkShaderModule          create_shader(const void* code, const size_t bytes);
@@ -78,18 +83,22 @@ public:
     void destroy_framebuffer(VkFramebuffer framebuffer);
     void destroy_pipeline(VkPipeline pipeline);
     void destroy_pipeline_layout(VkPipelineLayout layout);
+    void destroy_query_pool(VkQueryPool query_pool);
     void destroy_render_pass(VkRenderPass render_pass);
     void destroy_texture(const VulkanImageInfo& image_info);
     void destroy_semaphore(VkSemaphore semaphore);
     void destroy_shader(VkShaderModule shader);
     void unregister_swapchain_image(const VulkanImageInfo& image_info);
 
+    void  reset_command_pool(VkCommandPool command_pool);
     void  write_descriptor_bindings(VkDescriptorSet descriptor_set, const std::vector<DescriptorSetBinding>& binding);
-    void* map_buffer_memory(GPUBuffer& buffer, size_t bytes);
-    void  unmap_buffer_memory(GPUBuffer& buffer);
+    // Host writes through VulkanBuffer::mapped need a flush before the device reads them, and device writes an
+    // invalidate before the host reads them. Both do nothing for host coherent memory.
+    void  flush_buffer_memory(const GPUBuffer& buffer, size_t offset, size_t bytes);
+    void  invalidate_buffer_memory(const GPUBuffer& buffer, size_t offset, size_t bytes);
     void* map_image_memory(GPUTexture& texture, size_t bytes);
     void  unmap_image_memory(GPUTexture& texture);
-    void queue_submit(const VulkanCommandBuffer& cmd, QueueType queue, const std::vector<Semaphore*>& wait_for_semaphores, const std::vector<Semaphore*>& signal_semaphores, const Fence* signal_fence);
+    void queue_submit(const VulkanCommandBuffer& cmd, QueueType queue, const std::vector<Semaphore*>& wait_for_semaphores, const std::vector<Semaphore*>& signal_semaphores, const std::vector<TimelinePoint>& timeline_waits, const std::vector<TimelinePoint>& timeline_signals, const Fence* signal_fence);
 
     void set_debug_name(const std::string& name, VkObjectType type, uint64_t handle);
 
@@ -104,6 +113,8 @@ private:
     VulkanInstance*              _vulkan_instance{ nullptr };
     LogicalDevice*               _logical_device{ nullptr };
     PhysicalDevice*              _chosen_gpu{ nullptr };
+    std::vector<DeviceFeature>   _enabled_features;
+    VulkanMemoryAllocator*       _memory_allocator{ nullptr };
     VkDebugUtilsMessengerEXT     _validation_messenger{ VK_NULL_HANDLE };
 };
 
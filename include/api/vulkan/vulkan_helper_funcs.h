@@ -3,6 +3,7 @@
 
 #include <vulkan.h>
 
+#include "core/presentation_mode.h"
 #include "core/rend_defs.h"
 
 namespace rend
@@ -14,6 +15,7 @@ namespace vulkan_helpers
 VkImageType             find_image_type(VkExtent3D extent);
 VkImageViewType         find_image_view_type(VkImageType image_type, bool array, bool cube);
 VkImageAspectFlags      find_image_aspects(VkFormat format);
+VkAccessFlags2          find_layout_accesses(VkImageLayout layout);
 
 VkAttachmentDescription convert_attachment_description(const AttachmentInfo& info);
 VkFormat                convert_format(Format format);
@@ -27,8 +29,10 @@ VkAccessFlags           convert_memory_accesses(MemoryAccesses accesses);
 VkPipelineBindPoint     convert_pipeline_bind_point(PipelineBindPoint bind_point);
 VkPipelineStageFlagBits convert_pipeline_stage(PipelineStage stage);
 VkPipelineStageFlags    convert_pipeline_stages(PipelineStages stages);
+VkSubpassContents       convert_subpass_contents(SubPassContents contents);
 VkPushConstantRange     convert_push_constant_range(PushConstantRange push_constant_range);
 VkPrimitiveTopology     convert_topology(Topology topology);
+VkPresentModeKHR        convert_present_mode(PresentMode mode);
 VkPolygonMode           convert_polygon_mode(PolygonMode mode);
 VkFrontFace             convert_front_face(FrontFace face);
 VkCullModeFlagBits      convert_cull_mode(CullMode mode);
@@ -60,6 +64,7 @@ VkShaderModuleCreateInfo               gen_shader_module_create_info(void);
 VkPhysicalDeviceFeatures               gen_vk_1_0_features(void);
 VkPhysicalDeviceVulkan11Features       gen_vk_1_1_features(void);
 VkPhysicalDeviceVulkan12Features       gen_vk_1_2_features(void);
+VkPhysicalDeviceVulkan13Features       gen_vk_1_3_features(void);
 
 VkPipelineLayoutCreateInfo             gen_pipeline_layout_create_info(void);
 VkPipelineShaderStageCreateInfo        gen_shader_stage_create_info(void);
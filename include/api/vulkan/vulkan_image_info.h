@@ -1,6 +1,8 @@
 #ifndef REND_API_VULKAN_VULKAN_IMAGE_INFO_H
 #define REND_API_VULKAN_VULKAN_IMAGE_INFO_H
 
+#include "api/vulkan/vulkan_memory_allocation.h"
+
 #include <vulkan.h>
 
 namespace rend
@@ -8,11 +10,11 @@ namespace rend
 
 struct VulkanImageInfo
 {
-    VkImage        image{ VK_NULL_HANDLE };
-    VkDeviceMemory memory{ VK_NULL_HANDLE };
-    VkImageView    view{ VK_NULL_HANDLE };
-    VkSampler      sampler{ VK_NULL_HANDLE };
-    bool           is_swapchain{ false };
+    VkImage                image{ VK_NULL_HANDLE };
+    VulkanMemoryAllocation memory{};
+    VkImageView            view{ VK_NULL_HANDLE };
+    VkSampler              sampler{ VK_NULL_HANDLE };
+    bool                   is_swapchain{ false };
 };
 
 }
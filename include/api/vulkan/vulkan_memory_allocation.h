@@ -0,0 +1,27 @@
+#ifndef REND_API_VULKAN_VULKAN_MEMORY_ALLOCATION_H
+#define REND_API_VULKAN_VULKAN_MEMORY_ALLOCATION_H
+
+#include <cstdint>
+#include <vulkan.h>
+
+namespace rend
+{
+
+// A range of device memory handed out by VulkanMemoryAllocator, resources bind at offset
+struct VulkanMemoryAllocation
+{
+    static constexpr uint32_t C_DEDICATED{ 0xFFFFFFFF };
+
+    VkDeviceMemory memory{ VK_NULL_HANDLE };
+    VkDeviceSize   offset{ 0 };
+    VkDeviceSize   bytes{ 0 };
+    void*          mapped{ nullptr };       // Host address of offset, set when the memory is host visible
+    bool           host_coherent{ false };  // Mapped memory that needs no flush or invalidate
+    uint32_t       memory_type{ 0 };
+    uint32_t       block{ C_DEDICATED };    // Dedicated allocations own their memory outright
+    uint32_t       node{ 0xFFFFFFFF };
+};
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef REND_API_VULKAN_VULKAN_MEMORY_ALLOCATOR_H
+#define REND_API_VULKAN_VULKAN_MEMORY_ALLOCATOR_H
+
+#include "api/vulkan/vulkan_memory_allocation.h"
+#include "core/alloc/tlsf_allocator.h"
+
+#include <cstdint>
+#include <vector>
+#include <vulkan.h>
+
+namespace rend
+{
+
+class LogicalDevice;
+
+// Sub-allocates buffers and images out of large blocks of device memory, one list of blocks per memory type,
+// so resource creation rarely reaches vkAllocateMemory and stays far below maxMemoryAllocationCount.
+// Where bufferImageGranularity is above 1, buffers and images are kept in separate blocks rather than padded apart.
+// Large render targets get dedicated allocations, drivers can place them better on their own.
+// Host visible memory is mapped once for its lifetime, every allocation from it carries its host address.
+// Allocations from memory that is not host coherent cover whole nonCoherentAtomSize ranges, so flushing or
+// invalidating one never touches a neighbour.
+// Not thread safe, like the rest of resource creation.
+class VulkanMemoryAllocator
+{
+public:
+    explicit VulkanMemoryAllocator(LogicalDevice& logical_device);
+    ~VulkanMemoryAllocator(void);
+    VulkanMemoryAllocator(const VulkanMemoryAllocator&)            = delete;
+    VulkanMemoryAllocator(VulkanMemoryAllocator&&)                 = delete;
+    VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator& operator=(VulkanMemoryAllocator&&)      = delete;
+
+    // Memory is VK_NULL_HANDLE when no memory type fits or the heap is exhausted
+    [[nodiscard]] VulkanMemoryAllocation allocate_buffer(VkBuffer buffer, VkMemoryPropertyFlags memory_properties);
+    [[nodiscard]] VulkanMemoryAllocation allocate_image(VkImage image, VkMemoryPropertyFlags memory_properties, bool render_target);
+    void free(const VulkanMemoryAllocation& allocation);
+
+private:
+    static constexpr VkDeviceSize _BLOCK_BYTES{ 64ull * 1024 * 1024 };
+    static constexpr VkDeviceSize _SMALL_HEAP_BYTES{ 1024ull * 1024 * 1024 };   // Heaps this small get blocks of an eighth of their size
+    static constexpr VkDeviceSize _DEDICATED_RENDER_TARGET_BYTES{ 16ull * 1024 * 1024 };
+    static constexpr uint32_t     _NO_BLOCK{ 0xFFFFFFFF };
+
+    enum class Tiling : uint32_t
+    {
+        LINEAR,
+        OPTIMAL,
+        COUNT
+    };
+
+    struct Block
+    {
+        Block(VkDeviceMemory memory, void* mapped, uint32_t pool, VkDeviceSize bytes);
+
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        void*          mapped{ nullptr };
+        uint32_t       pool{ 0 };
+        TLSFAllocator  allocator;
+    };
+
+    [[nodiscard]] uint32_t               _find_memory_type(uint32_t memory_type_bits, VkMemoryPropertyFlags memory_properties) const;
+    [[nodiscard]] bool                   _is_host_coherent(uint32_t memory_type) const;
+    [[nodiscard]] VulkanMemoryAllocation _allocate(const VkMemoryRequirements& resource_reqs, VkMemoryPropertyFlags memory_properties, Tiling tiling);
+    [[nodiscard]] VulkanMemoryAllocation _allocate_dedicated(const VkMemoryRequirements& memory_reqs, VkMemoryPropertyFlags memory_properties, VkImage image);
+    [[nodiscard]] VkDeviceMemory         _allocate_memory(VkDeviceSize bytes, uint32_t memory_type, VkImage dedicated_image, void** mapped);
+    [[nodiscard]] uint32_t               _create_block(uint32_t pool, VkDeviceSize bytes);
+    void                                 _destroy_block(uint32_t block);
+
+private:
+    LogicalDevice&                        _logical_device;
+    VkPhysicalDeviceMemoryProperties      _memory_properties{};
+    VkDeviceSize                          _buffer_image_granularity{ 1 };
+    VkDeviceSize                          _non_coherent_atom_size{ 1 };
+    std::vector<Block*>                   _blocks;
+    std::vector<uint32_t>                 _unused_blocks;
+    std::vector<std::vector<uint32_t>>    _pools;         // Blocks by memory type and tiling
+    uint32_t                              _dedicated_count{ 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef REND_API_VULKAN_VULKAN_PASS_QUERIES_H
+#define REND_API_VULKAN_VULKAN_PASS_QUERIES_H
+
+#include "core/draw_pass.h"
+#include "core/rend_defs.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan.h>
+
+namespace rend
+{
+
+class Framebuffer;
+class RenderPass;
+class VulkanCommandBuffer;
+class VulkanCommandPool;
+class VulkanDeviceContext;
+
+// Timestamp and pipeline statistics queries for the draw passes of one frame in flight. Each pass writes a
+// timestamp before it begins, one as each subpass after the first begins, and one after it ends, with a pipeline
+// statistics query around the whole pass.
+// Results are only read once the frame's submit has completed, so reading them never stalls.
+class VulkanPassQueries
+{
+public:
+    VulkanPassQueries(const std::string& name, VulkanDeviceContext& device_context, bool pipeline_statistics);
+    ~VulkanPassQueries(void);
+    VulkanPassQueries(const VulkanPassQueries&)            = delete;
+    VulkanPassQueries(VulkanPassQueries&&)                 = delete;
+    VulkanPassQueries& operator=(const VulkanPassQueries&) = delete;
+    VulkanPassQueries& operator=(VulkanPassQueries&&)      = delete;
+
+    // Timestamps need a graphics queue that can write them
+    [[nodiscard]] static bool is_supported(const VulkanDeviceContext& device_context);
+
+    // Secondaries executed during a pass must inherit these
+    [[nodiscard]] VkQueryPipelineStatisticFlags pipeline_statistics(void) const;
+
+    // Replaces timings with the passes recorded in the frame's last use. Call once its submit has completed,
+    // passes whose results are not available are left out rather than waited for.
+    void read_results(std::vector<GPUPassTiming>& timings);
+
+    // Must be recorded ahead of the frame's first pass, outside a render pass
+    void reset(VulkanCommandBuffer& command_buffer);
+
+    // Passes past the pools' capacity go untimed
+    void begin_pass(VulkanCommandBuffer& command_buffer, const std::string& name, uint32_t subpasses_count);
+    void begin_subpass(VulkanCommandBuffer& command_buffer, const std::string& name, SubPassContents contents, const RenderPass& render_pass, uint32_t subpass, const Framebuffer* framebuffer);
+    void end_pass(VulkanCommandBuffer& command_buffer);
+
+private:
+    static constexpr uint32_t _PASSES_MAX{ 64 };
+    static constexpr uint32_t _TIMESTAMPS_MAX{ 256 };
+    static constexpr uint32_t _STATISTICS_COUNT{ 5 }; // Bits set in _pipeline_statistics
+    static constexpr uint32_t _NO_PASS{ 0xFFFFFFFF };
+
+    // Timestamps are the pass begin, the start of each subpass after the first, then the pass end
+    struct PassQuery
+    {
+        std::string              name;
+        uint32_t                 first_timestamp{ 0 };
+        uint32_t                 subpasses_count{ 0 };
+        std::vector<std::string> subpass_names;
+    };
+
+private:
+    std::string          _name;
+    VulkanDeviceContext& _device_context;
+    VkQueryPool          _timestamp_pool{ VK_NULL_HANDLE };
+    VkQueryPool          _statistics_pool{ VK_NULL_HANDLE };
+    VkQueryPipelineStatisticFlags _pipeline_statistics{ 0 };
+    double               _timestamp_period_ns{ 1.0 };
+    uint64_t             _timestamp_mask{ 0 };
+
+    // Subpasses recorded in secondaries can only be timed from a secondary of their own
+    VulkanCommandPool*   _command_pool{ nullptr };
+
+    std::vector<PassQuery> _passes;
+    uint32_t               _timestamps_used{ 0 };
+    uint32_t               _active_pass{ _NO_PASS };
+};
+
+}
+
+#endif
@@ -23,9 +23,9 @@ public:
 
     VkRenderPass vk_handle(void) const;
 
-    void begin(CommandBuffer& command_buffer, const PerPassData& per_pass_data) override;
+    void begin(CommandBuffer& command_buffer, const PerPassData& per_pass_data, SubPassContents contents) override;
     void end(CommandBuffer& command_buffer) override;
-    void next_subpass(CommandBuffer& command_buffer) override;
+    void next_subpass(CommandBuffer& command_buffer, SubPassContents contents) override;
 
 private:
     VkRenderPass _vk_handle{ VK_NULL_HANDLE };
@@ -3,7 +3,9 @@
 
 #include "api/vulkan/vulkan_renderer.fdecl.h"
 
+#include "api/vulkan/vulkan_barrier_batch.h"
 #include "api/vulkan/vulkan_buffer.h"
+#include "api/vulkan/vulkan_command_pool.h"
 #include "api/vulkan/vulkan_descriptor_set.h"
 #include "api/vulkan/vulkan_descriptor_set_layout.h"
 #include "api/vulkan/vulkan_framebuffer.h"
@@ -12,10 +14,12 @@
 #include "api/vulkan/vulkan_render_pass.h"
 #include "api/vulkan/vulkan_shader.h"
 #include "api/vulkan/vulkan_texture.h"
-#include "core/containers/data_pool.h"
+#include "core/draw_sort_key.h"
+#include "core/frustum_culling.h"
+#include "core/job_system.h"
 #include "core/renderer.h"
+#include <array>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include <vulkan.h>
 
@@ -23,8 +27,12 @@ namespace rend
 {
 
 class Swapchain;
-class CommandPool;
+class TimelineSemaphore;
+class VulkanCommandBuffer;
 class VulkanDeviceContext;
+class VulkanPassQueries;
+class VulkanStagingRing;
+class VulkanUploadQueue;
 class Window;
 
 class VulkanRenderer : public Renderer
@@ -47,6 +55,7 @@ public:
     // Resource functions
     void load_buffer(GPUBuffer& buffer) override;
     void load_texture(GPUTexture& texture) override;
+    void execute_render_graph(const RenderGraph& render_graph) override;
     void transition(GPUTexture& texture, PipelineStages src, PipelineStages dst, ImageLayout final_layout);
     void write_descriptor_bindings(const DescriptorSet& descriptor_set);
     void submit_command_buffer(CommandBuffer* command_buffer);
@@ -86,34 +95,170 @@ protected:
     void _resize(void) override;
 
 private:
+    [[nodiscard]] GPUBuffer*     _create_buffer(const std::string& name, const BufferInfo& info, VkMemoryPropertyFlags memory_flags);
     [[nodiscard]] Framebuffer*   _create_framebuffer(const std::string& name, const FramebufferInfo& info);
     [[nodiscard]] PerPassData    _create_per_pass_data(const Framebuffer& fb, const ColourClear& colour_clear, const DepthStencilClear& depth_clear, const RenderArea& render_area);
 
-    VulkanBuffer* _create_staging_buffer(void);
-    void _destroy_staging_buffer(VulkanBuffer* buffer);
-
-    void _process_pre_render_tasks(void);
-    std::unordered_map<View*, std::unordered_map<RenderStrategy*, std::vector<DrawItem*>>> _sort_draw_items(void);
+    void _process_pre_render_commands(void);
+    void _upload_buffer(GPUBuffer& buffer);
+    void _queue_upload(GPUBuffer* buffer, GPUTexture* texture);
+    void _stage_pending_uploads(void);
+    [[nodiscard]] bool _stage_buffer(GPUBuffer& buffer, size_t& bytes_staged);
+    [[nodiscard]] bool _stage_texture(GPUTexture& texture, size_t& bytes_staged);
+    void _write_staging_copies(void);
+    void _update_retained_draw_items(void);
+    void _write_cull_item(uint32_t idx, const Mesh* mesh, View* view, const glm::mat4* transform);
+    void _select_lods(uint32_t begin, uint32_t end, const View& view);
+    void _build_view_jobs(void);
+    void _cull_and_sort_view(uint32_t job_idx);
+    void _gather_sorted_view(uint32_t job_idx);
+    void _sort_draw_items(void);
+    void _build_draw_batches(void);
+    void _write_indirect_commands(void);
     void _process_draw_items(void);
+    void _record_draw_job(uint32_t job_idx, uint32_t thread_idx);
+    void _record_draw_batches(CommandBuffer& command_buffer, SubPass& subpass, uint32_t batches_begin, uint32_t batches_end);
+    void _resize_instance_buffer(FrameData& frame, size_t bytes);
+    [[nodiscard]] GPUBuffer* _grow_buffer(GPUBuffer* buffer, size_t bytes, BufferUsage usage);
+
+private: // types
+    // An upload to a device local buffer or texture, staged over as many frames as the staging ring needs
+    struct PendingUpload
+    {
+        GPUBuffer*  buffer{ nullptr };
+        GPUTexture* texture{ nullptr };
+        size_t      bytes_staged{ 0 };
+    };
+
+    // Data to write to mapped memory, the copies for a frame's uploads are spread over the job system together
+    struct StagingCopy
+    {
+        void*       dst{ nullptr };
+        const void* src{ nullptr };
+        size_t      bytes{ 0 };
+        GPUBuffer*  flush_buffer{ nullptr };    // Set when dst is the buffer's own memory, flushed once written
+    };
+
+    // A transient draw item, found by its submission list
+    struct ViewItem
+    {
+        uint32_t list_idx{ 0 };
+        uint32_t item_idx{ 0 };
+    };
+
+    // The draw items of one view, culled and sorted on a worker into their own region of the per frame arrays
+    struct ViewJob
+    {
+        uint32_t cull_begin{ 0 };      // First index of the region in the cull and sort arrays
+        uint32_t transient_begin{ 0 }; // First index into _view_items
+        uint32_t transient_count{ 0 };
+        uint32_t retained_begin{ 0 };  // First index into _retained_sort_entries
+        uint32_t retained_count{ 0 };
+        uint32_t visible_count{ 0 };
+        uint32_t sorted_begin{ 0 };    // First index into _sorted_draw_items
+    };
+
+    // Sorted draw items sharing mesh and material, drawn with one instanced draw
+    struct DrawBatch
+    {
+        uint32_t items_begin{ 0 };
+        uint32_t items_end{ 0 };
+        uint32_t first_instance{ 0 };
+        uint32_t instance_stride{ 0 };
+    };
+
+    // One draw pass begun for a run of draw items sharing view and render strategy
+    struct RecordPass
+    {
+        DrawPass*   draw_pass{ nullptr };
+        PerPassData per_pass_data{};
+        uint32_t    first_job{ 0 };
+        uint32_t    jobs_count{ 0 };
+    };
+
+    // A chunk of draw batches for one subpass, recorded on a worker into a secondary command buffer
+    struct RecordJob
+    {
+        uint32_t             pass_idx{ 0 };
+        uint32_t             subpass_idx{ 0 };
+        uint32_t             batches_begin{ 0 };
+        uint32_t             batches_end{ 0 };
+        VulkanCommandBuffer* command_buffer{ nullptr };
+    };
 
 private: // vars
-    static const int _STAGING_BUFFERS_MAX = 8;
+    static constexpr uint32_t _DRAWS_PER_RECORD_JOB{ 256 };
+    static constexpr size_t   _INSTANCE_BUFFER_BYTES{ 1024 * 1024 };
+    static constexpr size_t   _INDIRECT_BUFFER_BYTES{ 64 * 1024 };
+    static constexpr size_t   _DRAW_DATA_ARENA_BYTES{ 1024 * 1024 };
 
     VulkanDeviceContext*      _device_context{ nullptr };
     Swapchain*                _swapchain{ nullptr };
     VkCommandPool             _command_pool{ VK_NULL_HANDLE };
     VkDescriptorPool          _descriptor_pool{ VK_NULL_HANDLE };
+    DescriptorSetLayout*      _instance_data_layout{ nullptr };
+    TimelineSemaphore*        _frame_timeline{ nullptr };
+    uint64_t                  _timeline_value{ 0 };
+    VulkanUploadQueue*        _upload_queue{ nullptr };
+    VulkanStagingRing*        _staging_ring{ nullptr };
+    size_t                    _staging_bytes{ 0 };
+    size_t                    _staging_bytes_max{ 0 };
+
+    // Draw pass timing, one set of queries per frame in flight when enabled
+    bool                            _gpu_pass_queries{ false };
+    std::vector<VulkanPassQueries*> _pass_queries;
+
+    // Transitions gathered while recording, each flushed as a single barrier
+    VulkanBarrierBatch        _load_barriers;
+    VulkanBarrierBatch        _draw_barriers;
+
+    std::vector<PendingUpload> _pending_uploads;
+    std::vector<StagingCopy> _staging_copies;
+
+    // Material descriptor set and pipeline handle indices are packed into draw sort keys
+    static constexpr uint32_t _DESCRIPTOR_SETS_MAX{ 1024 };
+    static constexpr uint32_t _PIPELINES_MAX{ 1024 };
+    static_assert(_DESCRIPTOR_SETS_MAX <= (1u << C_SORT_KEY_MATERIAL_BITS), "Descriptor set handles must fit in the draw sort key");
+    static_assert(_PIPELINES_MAX <= (1u << C_SORT_KEY_PIPELINE_BITS), "Pipeline handles must fit in the draw sort key");
 
-    DataPool<VulkanBuffer, _STAGING_BUFFERS_MAX> _staging_buffers;
     DataArray<VulkanBuffer> _buffers;
-    DataArray<VulkanDescriptorSet> _descriptor_sets;
+    DataArray<VulkanDescriptorSet> _descriptor_sets{ _DESCRIPTOR_SETS_MAX };
     DataArray<VulkanDescriptorSetLayout> _descriptor_set_layouts;
     DataArray<VulkanFramebuffer> _framebuffers;
-    DataArray<VulkanPipeline> _pipelines;
+    DataArray<VulkanPipeline> _pipelines{ _PIPELINES_MAX };
     DataArray<VulkanPipelineLayout> _pipeline_layouts;
     DataArray<VulkanRenderPass> _render_passes;
     DataArray<VulkanShader> _shaders;
     DataArray<VulkanTexture> _textures;
+
+    // Reused every frame so sorting draw items does not allocate once warmed up
+    std::vector<DrawSortEntry> _draw_sort_entries;
+    std::vector<DrawSortEntry> _draw_sort_scratch;
+    std::vector<DrawBatch>     _draw_batches;
+
+    // Visible draw items gathered in sorted order, batching and recording walk these front to back
+    DrawItemList _sorted_draw_items;
+
+    // Retained draw items stay sorted across frames, only the ones changed since the last frame are sorted
+    std::vector<DrawSortEntry> _retained_sort_entries;
+    std::vector<DrawSortEntry> _retained_sort_scratch;
+    std::vector<DrawSortEntry> _retained_visible_entries;
+
+    // Per frame work split by view, each view's region holds its transient items then its retained items
+    std::vector<ViewJob>     _view_jobs;
+    std::vector<ViewItem>    _view_items;
+    CullSpheres              _cull_spheres;
+    std::vector<uint8_t>     _cull_visible;
+    std::vector<const Mesh*> _cull_meshes;
+    std::vector<View*>       _cull_views;
+    std::vector<uint8_t>     _cull_lods;
+
+    // Draw recording, one command pool per job system thread per frame in flight
+    JobSystem* _job_system{ nullptr };
+    std::vector<std::vector<VulkanCommandPool*>> _record_command_pools;
+    std::vector<RecordPass>     _record_passes;
+    std::vector<RecordJob>      _record_jobs;
+    std::vector<CommandBuffer*> _record_execute_list;
 };
 
 }
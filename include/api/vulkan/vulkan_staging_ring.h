@@ -0,0 +1,97 @@
+#ifndef REND_API_VULKAN_VULKAN_STAGING_RING_H
+#define REND_API_VULKAN_VULKAN_STAGING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rend
+{
+
+class GPUBuffer;
+class VulkanBuffer;
+class VulkanDeviceContext;
+
+// Staging memory for part or all of one upload, written through data and copied from buffer at offset
+struct StagingAllocation
+{
+    void*            data{ nullptr };
+    const GPUBuffer* buffer{ nullptr };
+    uint32_t         offset{ 0 };
+    uint32_t         bytes{ 0 };
+};
+
+// One persistently mapped host visible buffer that uploads take their staging memory from in order, wrapping round
+// to its start once they reach its end. Memory is freed in the same order once the upload timeline passes the upload
+// that read it. An upload that does not fit in what is free grows the buffer, up to a maximum, and the old buffer
+// lives on until the uploads reading it complete. Once it cannot grow, uploads take what is free and stage the rest
+// on later frames. A single unit larger than the maximum grows the ring past it.
+// Not thread safe.
+class VulkanStagingRing
+{
+public:
+    VulkanStagingRing(VulkanDeviceContext& device_context, size_t capacity_bytes, size_t capacity_bytes_max);
+    ~VulkanStagingRing(void);
+    VulkanStagingRing(const VulkanStagingRing&)            = delete;
+    VulkanStagingRing(VulkanStagingRing&&)                 = delete;
+    VulkanStagingRing& operator=(const VulkanStagingRing&) = delete;
+    VulkanStagingRing& operator=(VulkanStagingRing&&)      = delete;
+
+    // Takes all of bytes when it fits, otherwise as many whole multiples of unit_bytes as are free.
+    // Bytes is 0 when not even one unit is free, the upload has to wait for earlier ones to complete, or when the
+    // ring cannot grow to fit a unit at all, see fits.
+    [[nodiscard]] StagingAllocation allocate(size_t bytes, size_t alignment, size_t unit_bytes);
+
+    // Whether a unit can ever be staged. Allocating a unit past the maximum raises it, so this is only false once
+    // growing to the unit's size has failed or the unit is past the 32 bit copy offsets.
+    [[nodiscard]] bool fits(size_t unit_bytes) const;
+
+    // Everything allocated since the last retire is read by the upload that signals upload_value
+    void retire(uint64_t upload_value);
+
+    // Frees everything retired at or below completed_value
+    void release(uint64_t completed_value);
+
+    [[nodiscard]] size_t capacity(void) const;
+    [[nodiscard]] size_t bytes_used(void) const;
+
+private:
+    // The head once an upload's allocations were made, memory up to it is free once the upload completes
+    struct Retirement
+    {
+        uint64_t upload_value{ 0 };
+        uint64_t head{ 0 };
+    };
+
+    // A buffer the ring grew out of, destroyed once the last upload reading it completes
+    struct OldBuffer
+    {
+        VulkanBuffer* buffer{ nullptr };
+        uint64_t      upload_value{ 0 };
+        bool          retired{ false };   // Until then the upload reading it has not been submitted
+    };
+
+    [[nodiscard]] size_t        _find_space(size_t bytes, size_t alignment, size_t& offset) const;
+    [[nodiscard]] VulkanBuffer* _create_buffer(size_t bytes);
+    void                        _destroy_buffer(VulkanBuffer* buffer);
+    void                        _grow(size_t bytes);
+
+private:
+    VulkanDeviceContext&    _device_context;
+    VulkanBuffer*           _buffer{ nullptr };
+    char*                   _mapped{ nullptr };
+    size_t                  _capacity{ 0 };
+    size_t                  _capacity_max{ 0 };
+    uint32_t                _buffers_created{ 0 };
+
+    // Positions count every byte ever allocated rather than wrapping, so head minus tail is always the bytes in use
+    uint64_t                _head{ 0 };
+    uint64_t                _tail{ 0 };
+    uint64_t                _retired_head{ 0 };
+    std::vector<Retirement> _retirements;
+    std::vector<OldBuffer>  _old_buffers;
+};
+
+}
+
+#endif
@@ -5,12 +5,22 @@
 #include "core/gpu_texture.h"
 
 #include <string>
+#include <vector>
+#include <vulkan.h>
 
 namespace rend
 {
 
 struct VulkanImageInfo;
 
+// What a mip of a layer was last used for, so the next transition knows what it has to wait on
+struct VulkanSubresourceState
+{
+    VkImageLayout         layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+    VkPipelineStageFlags2 stages{ VK_PIPELINE_STAGE_2_NONE };
+    VkAccessFlags2        accesses{ VK_ACCESS_2_NONE };
+};
+
 class VulkanTexture : public GPUTexture
 {
 public:
@@ -19,8 +29,18 @@ public:
 
     const VulkanImageInfo& vk_image_info(void) const;
 
+    uint32_t                      subresource_mips(void) const;
+    uint32_t                      subresource_layers(void) const;
+    const VulkanSubresourceState& get_subresource_state(uint32_t mip, uint32_t layer) const;
+    void                          set_subresource_state(uint32_t mip, uint32_t layer, const VulkanSubresourceState& state);
+
 private:
     VulkanImageInfo _vk_image_info{};
+
+    // One per mip of every layer, layer major
+    std::vector<VulkanSubresourceState> _subresource_states;
+    uint32_t                            _mips_count{ 1 };
+    uint32_t                            _layers_count{ 1 };
 };
 
 }
@@ -0,0 +1,89 @@
+#ifndef REND_API_VULKAN_VULKAN_UPLOAD_QUEUE_H
+#define REND_API_VULKAN_VULKAN_UPLOAD_QUEUE_H
+
+#include "api/vulkan/timeline_semaphore.h"
+#include "api/vulkan/vulkan_barrier_batch.h"
+#include "core/command_buffer.h"
+#include "core/rend_defs.h"
+
+#include <cstdint>
+#include <vector>
+#include <vulkan.h>
+
+namespace rend
+{
+
+class GPUBuffer;
+class GPUTexture;
+class VulkanCommandBuffer;
+class VulkanCommandPool;
+class VulkanDeviceContext;
+
+// Records staging copies on the transfer queue, so uploads run on the copy engine alongside graphics work
+// instead of in front of the frame's draws. When transfer and graphics are separate families each upload
+// releases its resource to the graphics family, and the matching acquires are recorded by submit().
+// Texture copies are held until submit so every texture's transitions go in one barrier before the copies and
+// one after, however many textures were uploaded.
+// A texture too big to stage at once can be uploaded in parts over several frames. Only the first part discards its
+// old contents, and it stays with the transfer queue until the last part releases it.
+class VulkanUploadQueue
+{
+public:
+    VulkanUploadQueue(VulkanDeviceContext& device_context, uint32_t frames_in_flight);
+    ~VulkanUploadQueue(void);
+    VulkanUploadQueue(const VulkanUploadQueue&)            = delete;
+    VulkanUploadQueue(VulkanUploadQueue&&)                 = delete;
+    VulkanUploadQueue& operator=(const VulkanUploadQueue&) = delete;
+    VulkanUploadQueue& operator=(VulkanUploadQueue&&)      = delete;
+
+    void start_frame(uint32_t frame_idx);
+    void upload(const GPUBuffer& staging_buffer, GPUBuffer& buffer, const BufferBufferCopyInfo& info);
+    void upload(const GPUBuffer& staging_buffer, GPUTexture& texture, const BufferImageCopyInfo& info, bool first_part, bool last_part);
+
+    // Submits the recorded uploads and records their acquires into acquire_cmd, which must run on the graphics
+    // queue. Anything reading the uploads waits on the returned point.
+    [[nodiscard]] TimelinePoint submit(VulkanCommandBuffer& acquire_cmd);
+
+    // Rows of the texture's data a part must be a multiple of, for its copies to keep to the queue's image granularity
+    [[nodiscard]] uint32_t                  texture_split_rows(const GPUTexture& texture) const;
+    [[nodiscard]] bool                      has_uploads(void) const;
+    [[nodiscard]] uint64_t                  get_completed_value(void) const;
+    [[nodiscard]] const CommandBufferStats& get_stats(void) const;
+
+private:
+    struct TextureCopy
+    {
+        const GPUBuffer*    staging_buffer{ nullptr };
+        GPUTexture*         texture{ nullptr };
+        BufferImageCopyInfo info{};
+    };
+
+    VulkanCommandBuffer* _get_command_buffer(void);
+
+private:
+    VulkanDeviceContext&            _device_context;
+    TimelineSemaphore*              _timeline{ nullptr };
+    uint64_t                        _timeline_value{ 0 };
+    uint32_t                        _transfer_family_index{ 0 };
+    uint32_t                        _graphics_family_index{ 0 };
+    VkExtent3D                      _image_granularity{};
+
+    // One pool per frame in flight, reset once the timeline passes the value of its last submit
+    std::vector<VulkanCommandPool*> _command_pools;
+    std::vector<uint64_t>           _command_pool_values;
+    uint32_t                        _frame_idx{ 0 };
+    VulkanCommandBuffer*            _command_buffer{ nullptr };
+
+    std::vector<TextureCopy>        _texture_copies;
+    VulkanBarrierBatch              _pre_copy_barriers;
+    VulkanBarrierBatch              _post_copy_barriers;
+    CommandBufferStats              _stats{};
+
+    // Acquires for the resources released by the recorded uploads, and the stages that first read them
+    VulkanBarrierBatch              _acquires;
+    VkPipelineStageFlags            _read_stages{ 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef REND_CORE_ALLOC_LINEAR_ALLOCATOR_H
+#define REND_CORE_ALLOC_LINEAR_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rend
+{
+
+// Bump allocator handing out cache line aligned memory. Allocation is a single atomic add, so any
+// number of threads can allocate at once without locking; a lock is only taken to chain on a new
+// block when the current one runs out. Nothing is freed individually, reset() recycles everything
+// and must only be called once no thread is allocating and nothing allocated is still in use.
+class LinearAllocator
+{
+public:
+    static constexpr size_t C_CACHE_LINE_BYTES{ 64 };
+
+    explicit LinearAllocator(size_t capacity_bytes);
+    ~LinearAllocator(void);
+    LinearAllocator(const LinearAllocator&)            = delete;
+    LinearAllocator(LinearAllocator&&)                 = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(LinearAllocator&&)      = delete;
+
+    [[nodiscard]] void* allocate(size_t bytes);
+
+    // Objects are never destructed, so only trivially destructible types may be created
+    template<class T, typename... Args>
+    [[nodiscard]] T* create(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "LinearAllocator does not run destructors");
+        static_assert(alignof(T) <= C_CACHE_LINE_BYTES, "LinearAllocator alignment is limited to a cache line");
+        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    void   reset(void);
+    size_t bytes_used(void) const;
+
+private:
+    struct Block
+    {
+        char*               data{ nullptr };
+        size_t              capacity{ 0 };
+        std::atomic<size_t> offset{ 0 };
+        Block*              next{ nullptr };
+    };
+
+    [[nodiscard]] Block* _create_block(size_t capacity_bytes);
+    [[nodiscard]] void*  _try_allocate(Block& block, size_t bytes);
+    [[nodiscard]] void*  _allocate_slow(size_t bytes);
+
+private:
+    std::atomic<Block*> _current{ nullptr };
+    Block*              _first{ nullptr };
+    std::mutex          _grow_mutex;
+};
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef REND_CORE_ALLOC_TLSF_ALLOCATOR_H
+#define REND_CORE_ALLOC_TLSF_ALLOCATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rend
+{
+
+// A range handed out by TLSFAllocator, node identifies it when freeing
+struct TLSFAllocation
+{
+    uint64_t offset{ 0 };
+    uint64_t bytes{ 0 };
+    uint32_t node{ 0xFFFFFFFF };
+};
+
+// Two level segregated fit allocator over a range of offsets, it owns no memory so it can manage anything
+// addressed by offset, like a GPU memory block. Free ranges are binned by size class, and a bitmap per level
+// finds a big enough bin in constant time. Freed ranges merge with free neighbours straight away.
+// Not thread safe.
+class TLSFAllocator
+{
+public:
+    static constexpr uint32_t C_NO_NODE{ 0xFFFFFFFF };
+
+    explicit TLSFAllocator(uint64_t capacity_bytes);
+    ~TLSFAllocator(void) = default;
+    TLSFAllocator(const TLSFAllocator&)            = delete;
+    TLSFAllocator(TLSFAllocator&&)                 = delete;
+    TLSFAllocator& operator=(const TLSFAllocator&) = delete;
+    TLSFAllocator& operator=(TLSFAllocator&&)      = delete;
+
+    // Alignment must be a power of two. The node is C_NO_NODE when no free range fits.
+    [[nodiscard]] TLSFAllocation allocate(uint64_t bytes, uint64_t alignment);
+    void free(const TLSFAllocation& allocation);
+
+    [[nodiscard]] uint64_t capacity(void) const;
+    [[nodiscard]] uint64_t bytes_used(void) const;
+    [[nodiscard]] uint32_t allocations_count(void) const;
+
+private:
+    // Sizes are kept in multiples of _GRANULARITY, so a range's offset is too
+    static constexpr uint64_t _GRANULARITY{ 16 };
+    static constexpr uint32_t _SL_BITS{ 5 };
+    static constexpr uint32_t _SL_COUNT{ 1 << _SL_BITS };
+    static constexpr uint32_t _FL_SHIFT{ _SL_BITS + 3 };    // Sizes below 1 << _FL_SHIFT share the first level
+    static constexpr uint32_t _FL_COUNT{ 64 - _FL_SHIFT + 1 };
+
+    struct Node
+    {
+        uint64_t offset{ 0 };
+        uint64_t bytes{ 0 };
+        uint32_t prev_physical{ C_NO_NODE };
+        uint32_t next_physical{ C_NO_NODE };
+        uint32_t prev_free{ C_NO_NODE };
+        uint32_t next_free{ C_NO_NODE };
+        bool     free{ false };
+    };
+
+    static void _mapping(uint64_t bytes, uint32_t& fl, uint32_t& sl);
+
+    [[nodiscard]] uint32_t _create_node(uint64_t offset, uint64_t bytes);
+    void                   _destroy_node(uint32_t node);
+    [[nodiscard]] uint32_t _find_free(uint64_t bytes);
+    void                   _insert_free(uint32_t node);
+    void                   _remove_free(uint32_t node);
+    [[nodiscard]] uint32_t _split(uint32_t node, uint64_t bytes);
+    void                   _merge_into_prev(uint32_t node);
+
+private:
+    uint64_t _capacity{ 0 };
+    uint64_t _bytes_used{ 0 };
+    uint32_t _allocations_count{ 0 };
+
+    uint64_t                                                 _fl_bitmap{ 0 };
+    std::array<uint32_t, _FL_COUNT>                          _sl_bitmaps{};
+    std::array<std::array<uint32_t, _SL_COUNT>, _FL_COUNT>   _free_heads{};
+
+    std::vector<Node>     _nodes;
+    std::vector<uint32_t> _unused_nodes;
+};
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef REND_CORE_BOUNDS_H
+#define REND_CORE_BOUNDS_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rend
+{
+
+struct AABB
+{
+    glm::vec3 min{ 0.0f };
+    glm::vec3 max{ 0.0f };
+};
+
+struct BoundingSphere
+{
+    glm::vec3 centre{ 0.0f };
+    float     radius{ 0.0f };
+};
+
+// Planes point inwards, normalised so plane.xyz . p + plane.w is the signed distance of p
+struct Frustum
+{
+    glm::vec4 planes[6]{};
+};
+
+// Positions are read as 3 floats at the start of each vertex, stride bytes apart
+AABB           compute_aabb(const void* vertices, size_t stride, uint32_t vertex_count);
+BoundingSphere compute_bounding_sphere(const AABB& aabb, const void* vertices, size_t stride, uint32_t vertex_count);
+BoundingSphere transform_bounding_sphere(const BoundingSphere& sphere, const glm::mat4& transform);
+Frustum        make_frustum(const glm::mat4& view_projection);
+
+}
+
+#endif
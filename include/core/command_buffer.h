@@ -4,6 +4,7 @@
 #include "core/gpu_resource.h"
 #include "core/rend_defs.h"
 
+#include <string>
 #include <vector>
 
 namespace rend
@@ -24,6 +25,36 @@ enum class CommandBufferState
     SUBMITTED
 };
 
+// Commands skipped since the last begin because they would not have changed any state
+struct CommandBufferStats
+{
+    uint32_t pipeline_binds_elided{ 0 };
+    uint32_t descriptor_set_binds_elided{ 0 };
+    uint32_t vertex_buffer_binds_elided{ 0 };
+    uint32_t index_buffer_binds_elided{ 0 };
+    uint32_t viewports_elided{ 0 };
+    uint32_t scissors_elided{ 0 };
+    uint32_t push_constants_elided{ 0 };
+    uint32_t pipeline_barriers{ 0 };
+    uint32_t image_barriers{ 0 };
+    uint32_t buffer_barriers{ 0 };
+
+    CommandBufferStats& operator+=(const CommandBufferStats& other)
+    {
+        pipeline_binds_elided       += other.pipeline_binds_elided;
+        descriptor_set_binds_elided += other.descriptor_set_binds_elided;
+        vertex_buffer_binds_elided  += other.vertex_buffer_binds_elided;
+        index_buffer_binds_elided   += other.index_buffer_binds_elided;
+        viewports_elided            += other.viewports_elided;
+        scissors_elided             += other.scissors_elided;
+        push_constants_elided       += other.push_constants_elided;
+        pipeline_barriers           += other.pipeline_barriers;
+        image_barriers              += other.image_barriers;
+        buffer_barriers             += other.buffer_barriers;
+        return *this;
+    }
+};
+
 class CommandBuffer : public GPUResource
 {
 public:
@@ -36,21 +67,29 @@ public:
     virtual ~CommandBuffer(void) = default;
 
     virtual CommandBufferState get_state(void) const = 0;
+    virtual const CommandBufferStats& get_stats(void) const = 0;
 
     virtual void reset(void) = 0;
-    virtual void bind_descriptor_sets(PipelineBindPoint bind_point, const PipelineLayout& pipeline_layout, const std::vector<const DescriptorSet*> descriptor_sets) = 0;
+    virtual void bind_descriptor_sets(PipelineBindPoint bind_point, const PipelineLayout& pipeline_layout, const std::vector<const DescriptorSet*>& descriptor_sets) = 0;
     virtual void bind_pipeline(PipelineBindPoint bind_point, const Pipeline& pipeline) = 0;
-    virtual void bind_vertex_buffer(const GPUBuffer& vertex_buffer) = 0;
-    virtual void bind_index_buffer(const GPUBuffer& index_buffer) = 0;
+    virtual void bind_vertex_buffer(const GPUBuffer& vertex_buffer, size_t offset = 0) = 0;
+    virtual void bind_index_buffer(const GPUBuffer& index_buffer, size_t offset = 0) = 0;
     virtual void blit(const GPUTexture& src, const GPUTexture& dst) = 0;
     virtual void copy(const GPUBuffer& src, const GPUBuffer& dst, const BufferBufferCopyInfo& info) = 0;
     virtual void copy(const GPUBuffer& src, const GPUTexture& dst, const BufferImageCopyInfo& info) = 0;
     virtual void copy(const GPUTexture& src, const GPUTexture& dst, const ImageImageCopyInfo& info) = 0;
     virtual void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) = 0;
     virtual void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) = 0;
+    virtual void draw_indexed_indirect(const GPUBuffer& buffer, size_t offset, uint32_t draw_count, uint32_t stride) = 0;
+    virtual void execute_commands(const std::vector<CommandBuffer*>& command_buffers) = 0;
     virtual void push_constant(const PipelineLayout& layout, ShaderStages stages, uint32_t offset, size_t size, const void* data) = 0;
     virtual void set_viewport(const std::vector<ViewportInfo>& viewports) = 0;
     virtual void set_scissor(const std::vector<ViewportInfo>& scissors) = 0;
+
+    // Draw passes time themselves through these, they record nothing unless the renderer attached queries
+    virtual void begin_pass_query(const std::string& name, uint32_t subpasses_count) = 0;
+    virtual void begin_subpass_query(const std::string& name, SubPassContents contents) = 0;
+    virtual void end_pass_query(void) = 0;
 };
 
 }
@@ -0,0 +1,104 @@
+#ifndef REND_CORE_CONTAINERS_WORK_STEALING_DEQUE_H
+#define REND_CORE_CONTAINERS_WORK_STEALING_DEQUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace rend
+{
+
+// Fixed capacity Chase-Lev deque. The owning thread pushes and pops at the bottom, so it works through its most
+// recent items while they are still in cache. Any other thread may steal from the top, taking the oldest.
+// Orderings follow Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+template<typename T, size_t N>
+class WorkStealingDeque
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Items are copied without synchronisation beyond the indices");
+
+public:
+    WorkStealingDeque(void) = default;
+    ~WorkStealingDeque(void) = default;
+    WorkStealingDeque(const WorkStealingDeque&)            = delete;
+    WorkStealingDeque(WorkStealingDeque&&)                 = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&)      = delete;
+
+    // Owner only, false when full
+    bool push(T item)
+    {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const int64_t top    = _top.load(std::memory_order_acquire);
+        if(bottom - top >= static_cast<int64_t>(N))
+        {
+            return false;
+        }
+
+        // Releasing bottom publishes the item, and whatever was written before the push, to thieves
+        _items[bottom & _MASK].store(item, std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only
+    bool pop(T& item)
+    {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+
+        if(top > bottom)
+        {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = _items[bottom & _MASK].load(std::memory_order_relaxed);
+        if(top == bottom)
+        {
+            // Last item, race any thieves for it
+            const bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    // Any thread. Can fail while items remain if another thread took the top first.
+    bool steal(T& item)
+    {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+        if(top >= bottom)
+        {
+            return false;
+        }
+
+        item = _items[top & _MASK].load(std::memory_order_relaxed);
+        return _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool empty(void) const
+    {
+        return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int64_t _MASK{ static_cast<int64_t>(N) - 1 };
+
+    // Thieves hammer top while the owner works at bottom, keep them on separate cache lines
+    alignas(64) std::atomic<int64_t> _top{ 0 };
+    alignas(64) std::atomic<int64_t> _bottom{ 0 };
+    alignas(64) std::array<std::atomic<T>, N> _items{};
+};
+
+}
+
+#endif
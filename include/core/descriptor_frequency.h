@@ -9,9 +9,10 @@ namespace rend
     enum DescriptorFrequency
     {
         VIEW = 0,
-        MATERIAL = 1
+        MATERIAL = 1,
+        DRAW = 2
     };
-    constexpr size_t DESCRIPTOR_FREQUENCY_COUNT = 2;
+    constexpr size_t DESCRIPTOR_FREQUENCY_COUNT = 3;
 }
 
 #endif
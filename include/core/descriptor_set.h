@@ -32,9 +32,14 @@ public /*methods*/:
     void bind_resource(const DescriptorSetBinding& descriptor);
     virtual void write_bindings(void) const = 0;
 
+    // One per dynamic buffer binding, in slot order, applied each time the set is bound. Changing them needs no rewrite.
+    void                         set_dynamic_offsets(const std::vector<uint32_t>& offsets);
+    const std::vector<uint32_t>& get_dynamic_offsets(void) const;
+
 private /*variables*/:
     const DescriptorSetLayout&        _layout;
     std::vector<DescriptorSetBinding> _bindings;
+    std::vector<uint32_t>             _dynamic_offsets;
 };
 
 }
@@ -13,6 +13,7 @@ struct DescriptorSetBinding
     uint32_t       slot { 0 };
     DescriptorType type;
     GPUResource*   resource{ nullptr };
+    size_t         range{ 0 }; // Bytes of a buffer visible from its offset, zero for all of it. Dynamic buffers must set it.
 };
 
 }
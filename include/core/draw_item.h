@@ -46,6 +46,7 @@ struct DrawItem
     View* view{ nullptr };
     Material* material{ nullptr };
     PerDrawData per_draw_data;
+    const glm::mat4* transform{ nullptr }; // World transform for culling, items without one are always drawn
 };
 
 }
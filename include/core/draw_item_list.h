@@ -0,0 +1,42 @@
+#ifndef REND_CORE_DRAW_ITEM_LIST_H
+#define REND_CORE_DRAW_ITEM_LIST_H
+
+#include "core/draw_item.h"
+#include "core/draw_sort_key.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rend
+{
+
+class Material;
+class Mesh;
+class RenderStrategy;
+class View;
+
+// Draw items split into parallel arrays, so culling, sorting and recording each stream only the
+// fields they read. The sort key and render strategy are resolved once, when an item is written.
+struct DrawItemList
+{
+    std::vector<DrawSortKey>      keys;
+    std::vector<Mesh*>            meshes;
+    std::vector<Material*>        materials;
+    std::vector<View*>            views;
+    std::vector<RenderStrategy*>  render_strategies;
+    std::vector<const glm::mat4*> transforms;
+    std::vector<PerDrawData>      per_draw_datas;
+
+    uint32_t size(void) const;
+    void     clear(void);
+    void     resize(uint32_t count);
+    uint32_t push_back(const DrawItem& draw_item);
+    void     append(std::span<const DrawItem> draw_items);
+    void     set(uint32_t idx, const DrawItem& draw_item);
+    void     copy(uint32_t idx, const DrawItemList& src, uint32_t src_idx);
+};
+
+}
+
+#endif
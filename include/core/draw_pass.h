@@ -21,6 +21,27 @@ class SubPass;
 struct PerPassData;
 struct SubPassInfo;
 
+// GPU time spent in a subpass, from its start to the next subpass or the end of the pass
+struct GPUSubPassTiming
+{
+    std::string name;
+    double      gpu_ms{ 0.0 };
+};
+
+// GPU time and pipeline statistics for one execution of a draw pass. The invocation counts stay 0 when the
+// device cannot query pipeline statistics.
+struct GPUPassTiming
+{
+    std::string name;
+    double      gpu_ms{ 0.0 };
+    uint64_t    input_assembly_vertices{ 0 };
+    uint64_t    input_assembly_primitives{ 0 };
+    uint64_t    vertex_shader_invocations{ 0 };
+    uint64_t    clipping_primitives{ 0 };
+    uint64_t    fragment_shader_invocations{ 0 };
+    std::vector<GPUSubPassTiming> subpasses;
+};
+
 struct DrawPassInfo
 {
     std::string named_framebuffer;
@@ -37,6 +58,7 @@ class DrawPass : public GPUResource//, public RendObject
         ~DrawPass(void);
 
         std::vector<SubPass>& get_subpasses(void);
+        const RenderPass& get_render_pass(void) const;
         const std::string& get_named_framebuffer(void) const;
         const ColourClear& get_colour_clear(void) const;
         const DepthStencilClear& get_depth_stencil_clear(void) const;
@@ -44,9 +66,10 @@ class DrawPass : public GPUResource//, public RendObject
         bool has_next_subpass(void) const;
         void add_subpass(const std::string& name, const SubPassInfo& info);
 
-        void begin(CommandBuffer& command_buffer, const PerPassData& per_pass);
+        // With secondary contents the primary only executes secondaries, so pipelines are bound by the caller
+        void begin(CommandBuffer& command_buffer, const PerPassData& per_pass, SubPassContents contents = SubPassContents::INLINE);
         void end(CommandBuffer& command_buffer);
-        void next_subpass(CommandBuffer& command_buffer);
+        void next_subpass(CommandBuffer& command_buffer, SubPassContents contents = SubPassContents::INLINE);
 
     private:
         RenderPass& _render_pass;
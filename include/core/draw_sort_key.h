@@ -0,0 +1,81 @@
+#ifndef REND_CORE_DRAW_SORT_KEY_H
+#define REND_CORE_DRAW_SORT_KEY_H
+
+#include "core/containers/data_array_base.h"
+#include "core/rend_object.h"
+
+#include <assert.h>
+#include <cstdint>
+
+namespace rend
+{
+
+typedef uint64_t DrawSortKey;
+
+// Packed draw key, most significant field first so a plain integer sort groups
+// draws by view, then render strategy, pipeline, material set, mesh and finally level of detail.
+//
+//  63      56 55      48 47        36 35            20 19           3 2   0
+// [  view   ][ strategy ][ pipeline  ][ material set  ][    mesh     ][ lod ]
+//
+// Each field is wide enough for every index of the container its handle comes from, the renderers size those
+// containers from these and static_assert that they fit.
+static const uint32_t C_SORT_KEY_LOD_BITS{ 3 };
+static const uint32_t C_SORT_KEY_MESH_BITS{ 17 };
+static const uint32_t C_SORT_KEY_MATERIAL_BITS{ 16 };
+static const uint32_t C_SORT_KEY_PIPELINE_BITS{ 12 };
+static const uint32_t C_SORT_KEY_RENDER_STRATEGY_BITS{ 8 };
+static const uint32_t C_SORT_KEY_VIEW_BITS{ 8 };
+
+static const uint32_t C_SORT_KEY_LOD_SHIFT{ 0 };
+static const uint32_t C_SORT_KEY_MESH_SHIFT{ C_SORT_KEY_LOD_SHIFT + C_SORT_KEY_LOD_BITS };
+static const uint32_t C_SORT_KEY_MATERIAL_SHIFT{ C_SORT_KEY_MESH_SHIFT + C_SORT_KEY_MESH_BITS };
+static const uint32_t C_SORT_KEY_PIPELINE_SHIFT{ C_SORT_KEY_MATERIAL_SHIFT + C_SORT_KEY_MATERIAL_BITS };
+static const uint32_t C_SORT_KEY_RENDER_STRATEGY_SHIFT{ C_SORT_KEY_PIPELINE_SHIFT + C_SORT_KEY_PIPELINE_BITS };
+static const uint32_t C_SORT_KEY_VIEW_SHIFT{ C_SORT_KEY_RENDER_STRATEGY_SHIFT + C_SORT_KEY_RENDER_STRATEGY_BITS };
+
+static_assert(C_SORT_KEY_VIEW_SHIFT + C_SORT_KEY_VIEW_BITS == 64, "Draw sort key fields must fill 64 bits");
+
+// Mask selecting the fields that decide which draw passes an item is recorded into
+static const DrawSortKey C_SORT_KEY_PASS_MASK{ ~((DrawSortKey(1) << C_SORT_KEY_PIPELINE_SHIFT) - 1) };
+
+// Level of detail is picked per frame, keys are built with level 0 and have it set after culling
+static const DrawSortKey C_SORT_KEY_LOD_MASK{ (DrawSortKey(1) << C_SORT_KEY_LOD_BITS) - 1 };
+
+// Set in DrawSortEntry::item_idx when the entry refers to a retained draw item rather than a transient one
+static const uint32_t C_SORT_ENTRY_RETAINED_BIT{ 0x80000000 };
+
+struct DrawSortEntry
+{
+    DrawSortKey key{ 0 };
+    uint32_t    item_idx{ 0 };
+};
+
+constexpr DrawSortKey sort_key_field(RendHandle handle, uint32_t bits, uint32_t shift)
+{
+    assert(handle == REND_NULL_HANDLE || (handle & c_index_mask) < (DrawSortKey(1) << bits));
+    return handle == REND_NULL_HANDLE ? 0 : ((handle & c_index_mask) & ((DrawSortKey(1) << bits) - 1)) << shift;
+}
+
+constexpr DrawSortKey make_draw_sort_key(RendHandle view, RendHandle render_strategy, RendHandle pipeline, RendHandle material_set, RendHandle mesh)
+{
+    return sort_key_field(view,            C_SORT_KEY_VIEW_BITS,            C_SORT_KEY_VIEW_SHIFT)            |
+           sort_key_field(render_strategy, C_SORT_KEY_RENDER_STRATEGY_BITS, C_SORT_KEY_RENDER_STRATEGY_SHIFT) |
+           sort_key_field(pipeline,        C_SORT_KEY_PIPELINE_BITS,        C_SORT_KEY_PIPELINE_SHIFT)        |
+           sort_key_field(material_set,    C_SORT_KEY_MATERIAL_BITS,        C_SORT_KEY_MATERIAL_SHIFT)        |
+           sort_key_field(mesh,            C_SORT_KEY_MESH_BITS,            C_SORT_KEY_MESH_SHIFT);
+}
+
+constexpr DrawSortKey set_sort_key_lod(DrawSortKey key, uint32_t lod)
+{
+    return (key & ~C_SORT_KEY_LOD_MASK) | (DrawSortKey(lod) & C_SORT_KEY_LOD_MASK);
+}
+
+constexpr uint32_t get_sort_key_lod(DrawSortKey key)
+{
+    return static_cast<uint32_t>(key & C_SORT_KEY_LOD_MASK);
+}
+
+}
+
+#endif
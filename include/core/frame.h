@@ -13,12 +13,12 @@ namespace rend
 {
 
 class CommandBuffer;
-class Semaphore;
+class DescriptorSet;
 class SwapchainAcquire;
-class Fence;
 class Framebuffer;
 class GPUBuffer;
 class GPUTexture;
+class LinearAllocator;
 
 struct FrameData
 {
@@ -26,13 +26,15 @@ struct FrameData
     GPUTexture*    backbuffer_texture{ nullptr };
     CommandBuffer* draw_cmd{ nullptr };
     CommandBuffer* load_cmd{ nullptr };
-    Semaphore*     load_sem{ nullptr };
-    Fence*         submit_fen{ nullptr };
+    uint64_t       submit_value{ 0 }; // Frame timeline value signalled once this frame's last submit completes
     SwapchainAcquire acquire;
+    GPUBuffer*     instance_buffer{ nullptr };
+    DescriptorSet* instance_set{ nullptr };
+    GPUBuffer*     indirect_buffer{ nullptr };
+    LinearAllocator* draw_data_arena{ nullptr };
 
     std::vector<Framebuffer*> framebuffers;
     std::vector<GPUTexture*>  render_targets;
-    std::vector<GPUBuffer*>   staging_buffers_used;
 
     [[nodiscard]] GPUTexture*  find_render_target(const std::string& name) const;
     [[nodiscard]] Framebuffer* find_framebuffer(const std::string& name) const;
@@ -0,0 +1,35 @@
+#ifndef REND_CORE_FRUSTUM_CULLING_H
+#define REND_CORE_FRUSTUM_CULLING_H
+
+#include "core/bounds.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rend
+{
+
+// World space bounding spheres stored as separate arrays so they can be tested several at a time
+struct CullSpheres
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+
+    void resize(size_t count);
+};
+
+struct CullStats
+{
+    uint32_t draw_items_submitted{ 0 };
+    uint32_t draw_items_visible{ 0 };
+};
+
+// Writes 1 to visible[i] for every sphere in [first, first + count) at least partly inside the frustum, 0 otherwise.
+// Uses AVX or SSE when the build targets them. A sphere with infinite radius is always visible.
+void cull_spheres(const Frustum& frustum, const CullSpheres& spheres, uint32_t first, uint32_t count, uint8_t* visible);
+
+}
+
+#endif
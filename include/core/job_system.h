@@ -0,0 +1,129 @@
+#ifndef REND_CORE_JOB_SYSTEM_H
+#define REND_CORE_JOB_SYSTEM_H
+
+#include "core/containers/work_stealing_deque.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rend
+{
+
+typedef std::function<void(uint32_t thread_idx)>                    JobFunc;
+typedef std::function<void(uint32_t task_idx, uint32_t thread_idx)> ParallelForFunc;
+
+class JobSystem;
+
+// Handle to a job, only the job system touches its members
+struct Job
+{
+private:
+    friend class JobSystem;
+    static constexpr uint32_t _DEPENDENTS_MAX{ 8 };
+
+    JobFunc         func;
+    Job*            parent{ nullptr };
+
+    // Parallel for jobs run for_func on their children's ranges, children point back at it through for_source
+    ParallelForFunc for_func;
+    Job*            for_source{ nullptr };
+    uint32_t        for_begin{ 0 };
+    uint32_t        for_end{ 0 };
+    uint32_t        for_grain{ 1 };
+
+    std::atomic<uint32_t> unfinished{ 0 }; // Itself and its unfinished children
+    std::atomic<uint32_t> pending{ 0 };    // Incomplete dependencies, plus one until submitted
+    std::atomic<uint32_t> dependents_count{ 0 };
+    std::atomic<bool>     complete{ true };    // Set once nothing touches the job any more, unused slots count
+    std::array<std::atomic<Job*>, _DEPENDENTS_MAX> dependents{};
+};
+
+// Work stealing scheduler shared by the renderer and the application, so both fan out over one set of threads
+// instead of oversubscribing cores. Each thread owns a deque of ready jobs, works through it newest first and
+// steals the oldest from other threads when it runs dry.
+// Jobs are created held, so children and dependencies can be added before submit releases them. A job completes
+// once it and all its children have run, and only then do the jobs depending on it become ready.
+// The thread that initialises the system takes part as thread index 0 whenever it waits, workers take indices
+// 1..worker_count, so per-thread resources can be indexed directly. Only those threads may use the system.
+// Each thread creates jobs in a ring of _JOBS_PER_THREAD_MAX slots, skipping those whose job is incomplete, so job
+// handles stay valid until the creating thread has created that many more jobs. With every slot in use, creating a
+// job runs queued jobs until one frees up.
+class JobSystem
+{
+public:
+    static void       initialise(uint32_t worker_count);
+    static void       uninitialise(void);
+    static JobSystem& get_instance(void);
+
+    explicit JobSystem(uint32_t worker_count);
+    ~JobSystem(void);
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem(JobSystem&&)                 = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem& operator=(JobSystem&&)      = delete;
+
+    [[nodiscard]] uint32_t thread_count(void) const;
+    [[nodiscard]] uint32_t thread_index(void) const;
+
+    // Parent, if given, does not complete until this job has
+    [[nodiscard]] Job* create_job(JobFunc func, Job* parent = nullptr);
+
+    // Job completes once func has run for every task index in [0, task_count), grain indices per child job
+    [[nodiscard]] Job* create_parallel_for(uint32_t task_count, ParallelForFunc func, uint32_t grain = 1);
+
+    // Job does not start until dependency completes. Only valid before job is submitted.
+    void add_dependency(Job* job, Job* dependency);
+    void submit(Job* job);
+
+    // Runs other jobs while waiting
+    void wait(Job* job);
+    [[nodiscard]] bool is_complete(const Job* job) const;
+
+    // Runs func for every task index in [0, task_count) and returns once all have completed
+    void parallel_for(uint32_t task_count, const ParallelForFunc& func, uint32_t grain = 1);
+
+private:
+    static constexpr uint32_t _JOBS_PER_THREAD_MAX{ 2048 };
+    static constexpr uint32_t _DEQUE_CAPACITY{ 1024 };
+    static constexpr uint32_t _SPINS_BEFORE_SLEEP{ 64 };
+    static constexpr uint32_t _CLOSED{ 0xFFFFFFFF }; // Dependents count of a completed job
+
+    struct ThreadData
+    {
+        WorkStealingDeque<Job*, _DEQUE_CAPACITY> deque;
+        std::array<Job, _JOBS_PER_THREAD_MAX>    jobs;
+        uint32_t                                 next_job{ 0 };
+        uint32_t                                 steal_seed{ 0 };
+    };
+
+    Job* _allocate_job(void);
+    void _release(Job* job);
+    void _push(Job* job);
+    Job* _find_job(uint32_t thread_idx);
+    void _execute(Job* job, uint32_t thread_idx);
+    void _finish(Job* job);
+    void _worker_main(uint32_t thread_idx);
+
+private:
+    std::vector<ThreadData>  _thread_datas;
+    std::vector<std::thread> _workers;
+
+    // Sleeping workers are woken when jobs are queued
+    std::mutex               _mutex;
+    std::condition_variable  _work_cv;
+    std::atomic<int64_t>     _queued_jobs{ 0 };
+    std::atomic<uint32_t>    _sleeping_workers{ 0 };
+    std::atomic<bool>        _shutdown{ false };
+
+    static JobSystem* _instance;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <string>
 
 namespace rend::core::logging
@@ -19,6 +20,7 @@ namespace rend::core::logging
         private: // vars
             std::string _filepath;
             std::ofstream _stream;
+            std::mutex _stream_mutex;
     };
 }
 
@@ -1,29 +1,68 @@
 #ifndef REND_CORE_MESH_H
 #define REND_CORE_MESH_H
 
+#include "core/bounds.h"
 #include "core/gpu_resource.h"
+#include "core/mesh_lod.h"
 #include "core/rend_defs.h"
 #include "core/rend_object.h"
 
+#include <span>
 #include <string>
+#include <vector>
 
 namespace rend
 {
 
 class GPUBuffer;
 
+// The part of its vertex and index buffers a mesh draws. Meshes packed into the same buffers are bound once and,
+// with indirect draws, drawn together with one call per material.
+struct MeshRange
+{
+    int32_t  vertex_offset{ 0 }; // Added to each index, or the first vertex drawn without an index buffer
+    uint32_t vertex_count{ 0 };
+    uint32_t first_index{ 0 };
+    uint32_t index_count{ 0 };
+};
+
 class Mesh : public GPUResource, public RendObject
 {
     public:
-        Mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer);
+        static constexpr uint32_t C_LODS_MAX{ 8 };
+
+        Mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer, const MeshRange& range);
         ~Mesh(void);
 
-        GPUBuffer* get_vertex_buffer(void) const;
-        GPUBuffer* get_index_buffer(void) const;
+        GPUBuffer*       get_vertex_buffer(void) const;
+        GPUBuffer*       get_index_buffer(void) const;
+        const MeshRange& get_range(void) const;
+
+        // Bounds are computed from the vertex buffer when the mesh is created. Meshes without bounds are never culled.
+        bool                  has_bounds(void) const;
+        const AABB&           get_aabb(void) const;
+        const BoundingSphere& get_bounding_sphere(void) const;
+
+        // Computes bounds from the range's vertices in the vertex buffer's stored data, positions must be the first attribute.
+        // Call again after storing new vertex data.
+        void compute_bounds(void);
+        void set_bounds(const AABB& aabb, const BoundingSphere& sphere);
+
+        // Levels of detail as ranges of the mesh's indices, finest first, with first_index counted from the start of the
+        // mesh's range. Without any, level 0 draws the whole range.
+        uint32_t                 get_lods_count(void) const;
+        MeshLOD                  get_lod(uint32_t lod) const;
+        std::span<const MeshLOD> get_lods(void) const;
+        void                     set_lods(std::span<const MeshLOD> lods);
 
     private:
         GPUBuffer* _vertex_buffer{ nullptr };
         GPUBuffer* _index_buffer{ nullptr };
+        MeshRange      _range{};
+        AABB           _aabb{};
+        BoundingSphere _bounding_sphere{};
+        bool           _has_bounds{ false };
+        std::vector<MeshLOD> _lods;
 };
 
 }
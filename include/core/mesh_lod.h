@@ -0,0 +1,47 @@
+#ifndef REND_CORE_MESH_LOD_H
+#define REND_CORE_MESH_LOD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rend
+{
+
+// A range of a mesh's index buffer drawing the mesh at one level of detail.
+// Error is the furthest, in object space units, the range may stray from the full detail surface.
+struct MeshLOD
+{
+    uint32_t first_index{ 0 };
+    uint32_t index_count{ 0 };
+    float    error{ 0.0f };
+};
+
+// Index data for every level of a mesh one after another, upload indices as the mesh's index buffer
+struct MeshLODChain
+{
+    std::vector<uint32_t> indices;
+    std::vector<MeshLOD>  lods;
+};
+
+// Simplifies a triangle list by collapsing edges onto existing vertices, so the result still indexes the
+// same vertex buffer. Stops at target_index_count or when no collapse keeps the surface intact.
+// Positions are read as 3 floats at the start of each vertex, stride bytes apart.
+std::vector<uint32_t> simplify_indices(
+    const void* vertices, size_t stride, uint32_t vertex_count,
+    std::span<const uint32_t> indices, uint32_t target_index_count, float& out_error);
+
+// Builds up to lods_count levels, each simplified from the one before to about reduction of its triangles.
+// Level 0 is the indices as given.
+MeshLODChain build_lod_chain(
+    const void* vertices, size_t stride, uint32_t vertex_count,
+    std::span<const uint32_t> indices, uint32_t lods_count, float reduction = 0.5f);
+
+// Coarsest level whose error, seen from distance and scaled by projection_scale, stays within threshold pixels.
+// World scale is the scale from object to world space.
+uint32_t select_lod(std::span<const MeshLOD> lods, float world_scale, float distance, float projection_scale, float threshold);
+
+}
+
+#endif
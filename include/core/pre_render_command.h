@@ -0,0 +1,61 @@
+#ifndef REND_CORE_PRE_RENDER_COMMAND_H
+#define REND_CORE_PRE_RENDER_COMMAND_H
+
+#include "core/rend_defs.h"
+
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rend
+{
+
+class GPUBuffer;
+class GPUTexture;
+
+typedef void (*PreRenderCallback)(void* user_data);
+
+enum class PreRenderCommandType : uint8_t
+{
+    BUFFER_UPLOAD,
+    TEXTURE_UPLOAD,
+    TRANSITION,
+    CALLBACK
+};
+
+// Work run at the start of the next submitted frame, before its draws. Fields unused by the type are left null.
+struct PreRenderCommand
+{
+    PreRenderCommandType type{ PreRenderCommandType::CALLBACK };
+    ImageLayout          layout{ ImageLayout::UNDEFINED };
+    PipelineStages       src_stages{ 0 };
+    PipelineStages       dst_stages{ 0 };
+    GPUBuffer*           buffer{ nullptr };
+    GPUTexture*          texture{ nullptr };
+    PreRenderCallback    callback{ nullptr };
+    void*                user_data{ nullptr };
+};
+
+static_assert(std::is_trivially_copyable_v<PreRenderCommand>, "Pre render commands are copied around as plain data");
+
+// Pre render commands stored by value in one buffer that is cleared rather than freed, so recording stops
+// allocating once the buffer has grown to the busiest frame.
+class PreRenderCommandStream
+{
+public:
+    void push(const PreRenderCommand& command);
+    void clear(void);
+    bool empty(void) const;
+
+    // Sorts each run of uploads between transitions and callbacks by type and resource, and drops uploads repeated
+    // within a run since each reads the resource's data when processed. Returns the commands left.
+    std::span<const PreRenderCommand> coalesce(void);
+
+private:
+    std::vector<PreRenderCommand> _commands;
+};
+
+}
+
+#endif
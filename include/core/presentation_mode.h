@@ -7,6 +7,22 @@ namespace rend
     {
         DOUBLE_BUFFERING
     };
+
+    // How finished frames are queued for display. Modes the surface lacks fall back to FIFO.
+    enum class PresentMode
+    {
+        FIFO,     // Waits for vertical blank, never tears
+        MAILBOX,  // The newest frame replaces any still waiting, never tears
+        IMMEDIATE // Shown straight away, may tear
+    };
+
+    // Presets trading input latency against keeping the GPU busy
+    enum class LatencyMode
+    {
+        CUSTOM,         // Frames in flight, swapchain images and present mode as given
+        LOW_LATENCY,    // 1 frame in flight, 2 swapchain images, mailbox
+        HIGH_THROUGHPUT // 3 frames in flight, 4 swapchain images, FIFO
+    };
 }
 
 #endif
@@ -0,0 +1,69 @@
+#ifndef REND_CORE_PROFILER_H
+#define REND_CORE_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Zones are only recorded when built with REND_PROFILE, otherwise the macros expand to nothing
+#if REND_PROFILE
+    #define REND_PROFILE_CONCAT_INNER(a, b) a##b
+    #define REND_PROFILE_CONCAT(a, b) REND_PROFILE_CONCAT_INNER(a, b)
+    #define REND_PROFILE_ZONE(name) ::rend::ProfileZone REND_PROFILE_CONCAT(_profile_zone_, __LINE__){ name }
+    #define REND_PROFILE_THREAD(name) ::rend::Profiler::set_thread_name(name)
+#else
+    #define REND_PROFILE_ZONE(name)
+    #define REND_PROFILE_THREAD(name)
+#endif
+
+namespace rend
+{
+
+// Records timed zones into a ring per thread, so recording never takes a lock or allocates once a thread's ring
+// exists. Zone names must be string literals, only the pointer is kept.
+// The oldest zones are overwritten once a thread records more than _ZONES_PER_THREAD_MAX between dumps.
+class Profiler
+{
+public:
+    static void     set_thread_name(const std::string& name);
+    static uint64_t now(void);
+    static void     record(const char* name, uint64_t begin, uint64_t end);
+
+    // Writes every thread's recorded zones as Chrome trace event JSON, for chrome://tracing or Perfetto.
+    // Best called between frames, a zone recorded while its ring is being read may come out torn.
+    static bool write_chrome_trace(const std::string& path);
+
+private:
+    static constexpr size_t _ZONES_PER_THREAD_MAX{ 1 << 16 };
+};
+
+// Times its scope, use through REND_PROFILE_ZONE
+class ProfileZone
+{
+public:
+    template<size_t N>
+    explicit ProfileZone(const char (&name)[N])
+        :
+            _name(name),
+            _begin(Profiler::now())
+    {
+    }
+
+    ~ProfileZone(void)
+    {
+        Profiler::record(_name, _begin, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&)            = delete;
+    ProfileZone(ProfileZone&&)                 = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+    ProfileZone& operator=(ProfileZone&&)      = delete;
+
+private:
+    const char* _name{ nullptr };
+    uint64_t    _begin{ 0 };
+};
+
+}
+
+#endif
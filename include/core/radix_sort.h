@@ -0,0 +1,80 @@
+#ifndef REND_CORE_RADIX_SORT_H
+#define REND_CORE_RADIX_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace rend
+{
+
+// LSD radix sort over 64 bit keys, 8 bits per pass. Entries must expose a
+// uint64_t member named "key". Sorting ping-pongs between entries and scratch,
+// both of which must hold at least count elements; no memory is allocated.
+// Passes where every key shares the same byte are skipped. The result is
+// always left in entries and the sort is stable.
+template<class T>
+void radix_sort(T* entries, T* scratch, size_t count)
+{
+    static const uint32_t C_RADIX_BITS{ 8 };
+    static const uint32_t C_RADIX_BUCKETS{ 1 << C_RADIX_BITS };
+    static const uint32_t C_RADIX_PASSES{ 64 / C_RADIX_BITS };
+
+    if(count < 2)
+    {
+        return;
+    }
+
+    // Histogram all passes up front so only one read of the keys is needed
+    size_t histograms[C_RADIX_PASSES][C_RADIX_BUCKETS];
+    memset(histograms, 0, sizeof(histograms));
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = entries[i].key;
+        for(uint32_t pass = 0; pass < C_RADIX_PASSES; ++pass)
+        {
+            ++histograms[pass][(key >> (pass * C_RADIX_BITS)) & (C_RADIX_BUCKETS - 1)];
+        }
+    }
+
+    T* src = entries;
+    T* dst = scratch;
+
+    for(uint32_t pass = 0; pass < C_RADIX_PASSES; ++pass)
+    {
+        size_t* histogram = histograms[pass];
+        const uint32_t shift = pass * C_RADIX_BITS;
+
+        // All keys land in one bucket, this byte does not affect the order
+        if(histogram[(src[0].key >> shift) & (C_RADIX_BUCKETS - 1)] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for(uint32_t bucket = 0; bucket < C_RADIX_BUCKETS; ++bucket)
+        {
+            size_t bucket_count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucket_count;
+        }
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].key >> shift) & (C_RADIX_BUCKETS - 1)]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if(src != entries)
+    {
+        memcpy(entries, src, sizeof(T) * count);
+    }
+}
+
+}
+
+#endif
@@ -2,7 +2,9 @@
 #define REND_REND_H
 
 #include "api/vulkan/device_features.h"
+#include "core/presentation_mode.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <vulkan.h>
@@ -17,11 +19,15 @@ enum class API
     API_VULKAN
 };
 
+// Worker thread count that picks one per core besides the initialising thread's
+static const uint32_t C_WORKER_THREADS_AUTO{ 0xFFFFFFFF };
+
 struct VulkanInitInfo
 {
     std::vector<const char*> extensions;
     std::vector<const char*> layers;
     std::vector<DeviceFeature> features;
+    std::vector<DeviceFeature> optional_features; // Enabled when the chosen GPU has them, see VulkanDeviceContext::has_feature
     VkQueueFlags queues{};
 };
 
@@ -32,6 +38,16 @@ struct RendInitInfo
     const char* app_name{ nullptr };
     uint32_t    resolution_width{ 800 };
     uint32_t    resolution_height{ 600 };
+    bool        indirect_draws{ false }; // Issue instanced draws from a per frame indirect buffer, meshes sharing buffers draw one call per material
+    bool        gpu_pass_queries{ false }; // Time draw passes on the GPU, see Renderer::get_gpu_pass_timings
+    size_t      transient_bytes{ 4 * 1024 * 1024 }; // Per frame in flight, see Renderer::allocate_transient
+    size_t      staging_bytes{ 16 * 1024 * 1024 };      // Staging memory for uploads to start with
+    size_t      staging_bytes_max{ 256 * 1024 * 1024 }; // Staging grows up to this, uploads that still do not fit are split over frames
+    LatencyMode latency_mode{ LatencyMode::CUSTOM }; // Presets other than CUSTOM override the three below
+    uint32_t    frames_in_flight{ 2 };               // 1 to 4
+    uint32_t    swapchain_images{ 3 };               // A request, the surface may need more or allow fewer
+    PresentMode present_mode{ PresentMode::MAILBOX };
+    uint32_t    worker_threads{ C_WORKER_THREADS_AUTO }; // Job system threads besides the initialising one, 0 runs every job on it
 };
 
 void rend_initialise(const RendInitInfo& init_info);
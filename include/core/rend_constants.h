@@ -16,6 +16,9 @@ namespace constants
     constexpr size_t max_vertex_attributes{ 8 };
     constexpr size_t max_viewports{ 8 };
     constexpr size_t max_scissors{ 8 };
+    constexpr size_t max_descriptor_sets{ 8 };
+    constexpr size_t max_push_constant_bytes{ 128 };
+    constexpr size_t instance_data_alignment{ 16 }; // std430 alignment of a struct holding a vec4 or mat4
 }
 
 }
@@ -241,6 +241,12 @@ enum class PipelineBindPoint
     COMPUTE
 };
 
+enum class SubPassContents
+{
+    INLINE,
+    SECONDARY_COMMAND_BUFFERS
+};
+
 enum MemoryAccess
 {
     NO_ACCESS                      = 0,
@@ -444,7 +450,9 @@ enum class BufferUsage : uint32_t
     TRANSFER_DST   = BIT(1),
     VERTEX_BUFFER  = BIT(2),
     INDEX_BUFFER   = BIT(3),
-    UNIFORM_BUFFER = BIT(4)
+    UNIFORM_BUFFER = BIT(4),
+    STORAGE_BUFFER = BIT(5),
+    INDIRECT_BUFFER = BIT(6)
 };
 
 inline BufferUsage operator|(BufferUsage lhs, BufferUsage rhs)
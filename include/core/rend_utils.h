@@ -8,6 +8,12 @@ namespace rend
 
 bool is_depth_format(Format format);
 
+// Rounds value up to the next multiple of alignment, which need not be a power of two
+constexpr size_t align_up(size_t value, size_t alignment)
+{
+    return alignment == 0 ? value : ((value + alignment - 1) / alignment) * alignment;
+}
+
 }
 
 #endif
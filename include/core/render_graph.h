@@ -0,0 +1,133 @@
+#ifndef REND_CORE_RENDER_GRAPH_H
+#define REND_CORE_RENDER_GRAPH_H
+
+#include "core/rend_defs.h"
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace rend
+{
+
+class CommandBuffer;
+class GPUTexture;
+
+typedef uint32_t RenderGraphResource;
+typedef uint32_t RenderGraphPass;
+constexpr uint32_t C_RENDER_GRAPH_NULL{ std::numeric_limits<uint32_t>::max() };
+
+typedef void (*RenderGraphPassCallback)(CommandBuffer& command_buffer, void* user_data);
+
+// How a pass uses a resource, together with whether it reads or writes it this decides the layout, stages
+// and accesses the pass needs
+enum class RenderGraphUsage : uint8_t
+{
+    COLOUR_ATTACHMENT,
+    DEPTH_STENCIL_ATTACHMENT,
+    SHADER,
+    TRANSFER,
+    PRESENT
+};
+
+// Barrier to record before a pass so it sees the resource in the state it declared
+struct RenderGraphBarrier
+{
+    RenderGraphResource resource{ C_RENDER_GRAPH_NULL };
+    PipelineStages      src_stages{ PipelineStage::PIPELINE_STAGE_NONE };
+    PipelineStages      dst_stages{ PipelineStage::PIPELINE_STAGE_NONE };
+    MemoryAccesses      src_accesses{ MemoryAccess::NO_ACCESS };
+    MemoryAccesses      dst_accesses{ MemoryAccess::NO_ACCESS };
+    ImageLayout         old_layout{ ImageLayout::UNDEFINED };
+    ImageLayout         new_layout{ ImageLayout::UNDEFINED };
+};
+
+// Passes declare the named resources they read and write, in the order they would run. compile() works out
+// the dependencies between them, culls passes that nothing marked as output depends on, orders the rest so
+// dependent passes are spaced apart where possible, and computes the barriers each pass needs.
+// Nothing here touches the GPU, a backend records the barriers and runs the pass callbacks in pass order.
+// Resources are assumed to be idle in their initial layout when the graph starts.
+class RenderGraph
+{
+public:
+    RenderGraphResource add_resource(const std::string& name, ImageLayout initial_layout = ImageLayout::UNDEFINED);
+    void                set_texture(RenderGraphResource resource, GPUTexture* texture);
+    void                mark_output(RenderGraphResource resource);
+
+    RenderGraphPass add_pass(const std::string& name, RenderGraphPassCallback callback = nullptr, void* user_data = nullptr);
+    void            set_side_effects(RenderGraphPass pass);
+    void            read(RenderGraphPass pass, RenderGraphResource resource, RenderGraphUsage usage);
+    void            write(RenderGraphPass pass, RenderGraphResource resource, RenderGraphUsage usage);
+
+    void compile(void);
+    void clear(void);
+
+    [[nodiscard]] RenderGraphResource find_resource(const std::string& name) const;
+    [[nodiscard]] const std::string&  get_resource_name(RenderGraphResource resource) const;
+    [[nodiscard]] GPUTexture*         get_texture(RenderGraphResource resource) const;
+    [[nodiscard]] ImageLayout         get_final_layout(RenderGraphResource resource) const;
+
+    [[nodiscard]] const std::string&  get_pass_name(RenderGraphPass pass) const;
+    [[nodiscard]] bool                is_culled(RenderGraphPass pass) const;
+    void                              execute_pass(RenderGraphPass pass, CommandBuffer& command_buffer) const;
+
+    // Valid after compile, passes left after culling in the order they should be recorded
+    [[nodiscard]] std::span<const RenderGraphPass>    get_pass_order(void) const;
+    [[nodiscard]] std::span<const RenderGraphBarrier> get_barriers(RenderGraphPass pass) const;
+
+private:
+    struct Use
+    {
+        RenderGraphResource resource{ C_RENDER_GRAPH_NULL };
+        RenderGraphUsage    usage{ RenderGraphUsage::SHADER };
+        bool                write{ false };
+    };
+
+    struct Resource
+    {
+        std::string name;
+        GPUTexture* texture{ nullptr };
+        ImageLayout initial_layout{ ImageLayout::UNDEFINED };
+        ImageLayout final_layout{ ImageLayout::UNDEFINED };
+        bool        output{ false };
+    };
+
+    struct Pass
+    {
+        std::string             name;
+        RenderGraphPassCallback callback{ nullptr };
+        void*                   user_data{ nullptr };
+        std::vector<Use>        uses;
+        bool                    side_effects{ false };
+        bool                    culled{ false };
+        uint32_t                barriers_begin{ 0 };
+        uint32_t                barriers_count{ 0 };
+    };
+
+    // Pass to must run after pass from. Live edges carry data, the rest only stop a write overtaking a read.
+    struct Edge
+    {
+        RenderGraphPass from{ C_RENDER_GRAPH_NULL };
+        RenderGraphPass to{ C_RENDER_GRAPH_NULL };
+        bool            live{ false };
+    };
+
+    void _add_use(RenderGraphPass pass, RenderGraphResource resource, RenderGraphUsage usage, bool write);
+    void _build_edges(void);
+    void _cull_passes(void);
+    void _order_passes(void);
+    void _build_barriers(void);
+
+private:
+    std::vector<Resource>           _resources;
+    std::vector<Pass>               _passes;
+    std::vector<Edge>               _edges;
+    std::vector<RenderGraphPass>    _pass_order;
+    std::vector<RenderGraphBarrier> _barriers;
+};
+
+}
+
+#endif
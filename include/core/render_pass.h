@@ -55,8 +55,8 @@ public:
     bool has_depth_target(void) const;
     uint32_t colour_targets_count(void) const;
 
-    virtual void begin(CommandBuffer& command_buffer, const PerPassData& per_pass) = 0;
-    virtual void next_subpass(CommandBuffer& command_buffer) = 0;
+    virtual void begin(CommandBuffer& command_buffer, const PerPassData& per_pass, SubPassContents contents) = 0;
+    virtual void next_subpass(CommandBuffer& command_buffer, SubPassContents contents) = 0;
     virtual void end(CommandBuffer& command_buffer) = 0;
 
 private:
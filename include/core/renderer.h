@@ -1,21 +1,28 @@
 #ifndef REND_CORE_RENDERER_H
 #define REND_CORE_RENDERER_H
 
+#include "core/command_buffer.h"
+#include "core/alloc/linear_allocator.h"
 #include "core/containers/data_array.h"
 #include "core/containers/data_pool.h"
 #include "core/descriptor_set_layout.h"
+#include "core/draw_item_list.h"
 #include "core/draw_pass.h"
 #include "core/frame.h"
+#include "core/frustum_culling.h"
 #include "core/material.h"
 #include "core/mesh.h"
+#include "core/pre_render_command.h"
+#include "core/render_graph.h"
 #include "core/presentation_mode.h"
 #include "core/render_strategy.h"
 #include "core/shader_set.h"
 #include "core/sub_pass.h"
+#include "core/transient_allocator.h"
 #include "core/view.h"
 
-#include <functional>
-#include <queue>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -47,17 +54,59 @@ struct TextureInfo;
 class Renderer
 {
 public:
+    // Layout of the per frame instance data set, bind it at DescriptorFrequency::DRAW to draw instanced
+    static constexpr std::string C_INSTANCE_DATA_LAYOUT_NAME = "instance data";
+
     static void initialise(const RendInitInfo& init_info);
     static void shutdown(void);
     static Renderer& get_instance(void);
 
     Window* get_window(void) const;
 
+    // Safe to call from any thread between start_frame and end_frame, every thread appends to its own list.
+    // All submissions for a frame must have returned before end_frame is called.
     void add_draw_item(const DrawItem& draw_item);
-    void add_pre_render_task(std::function<void(void)> task_func);
+    void add_draw_items(std::span<const DrawItem> draw_items);
+    // Retained draw items are drawn every frame until removed. Their per draw data is read each frame, so
+    // it must outlive the item, but changes to mesh, view or material need update_retained_draw_item.
+    [[nodiscard]] RendHandle add_retained_draw_item(const DrawItem& draw_item);
+    void update_retained_draw_item(RendHandle handle, const DrawItem& draw_item);
+    void remove_retained_draw_item(RendHandle handle);
+    // Run before the next submitted frame's draws, in the order added. The callback's user data must stay valid until then.
+    void add_pre_render_task(PreRenderCallback callback, void* user_data);
+    void add_pre_render_transition(GPUTexture& texture, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout layout);
+
+    // Cache line aligned memory for PerDrawData payloads, valid until this frame in flight comes round again.
+    // Safe to call from any thread between start_frame and end_frame.
+    [[nodiscard]] void* allocate_draw_data(size_t bytes);
+
+    template<class T, typename... Args>
+    [[nodiscard]] T* create_draw_data(Args&&... args)
+    {
+        return _frame_datas[_current_frame].draw_data_arena->create<T>(std::forward<Args>(args)...);
+    }
+
+    // Mapped GPU memory for this frame's uniform, storage, vertex and index data, written directly with no upload.
+    // Valid until this frame in flight comes round again, data is null once RendInitInfo::transient_bytes is used up.
+    // Safe to call from any thread between start_frame and end_frame.
+    [[nodiscard]] TransientAllocation allocate_transient(TransientUsage usage, size_t bytes);
+
+    // Every transient slice is in this buffer, so dynamic descriptors only need writing against it once
+    [[nodiscard]] GPUBuffer& get_transient_buffer(void) const;
     //void add_point_light(glm::vec3 position, const PointLight& light);
     //void set_camera(const CameraData& camera);
     PresentationMode get_presentation_mode(void) const;
+    uint32_t         get_frames_in_flight(void) const;
+    // Redundant commands skipped while recording the last submitted frame
+    const CommandBufferStats& get_command_buffer_stats(void) const;
+    // Draw items submitted and left after frustum culling in the last frame
+    const CullStats& get_cull_stats(void) const;
+    // GPU time and statistics of every draw pass in the most recent frame whose results have been read back,
+    // frames in flight behind the current one. Empty unless RendInitInfo::gpu_pass_queries was set.
+    const std::vector<GPUPassTiming>& get_gpu_pass_timings(void) const;
+    // Meshes are drawn at the coarsest level of detail whose error stays within this many pixels on screen
+    void  set_lod_error_threshold(float pixels);
+    float get_lod_error_threshold(void) const;
 
     virtual void configure(void) = 0;
     virtual void start_frame(void) = 0;
@@ -66,6 +115,9 @@ public:
     virtual void get_size_by_ratio(SizeRatio size_ratio, uint32_t& width, uint32_t& height) = 0;
     virtual void load_buffer(GPUBuffer& buffer) = 0;
     virtual void load_texture(GPUTexture& texture) = 0;
+    // Records a compiled graph's passes, each after its barriers, ahead of this frame's draw items.
+    // Call between start_frame and end_frame, resources must have their textures set.
+    virtual void execute_render_graph(const RenderGraph& render_graph) = 0;
 
     [[nodiscard]] virtual GPUBuffer*           get_buffer(const std::string& name) const = 0;
     [[nodiscard]] virtual DescriptorSetLayout* get_descriptor_set_layout(const std::string& name) const = 0;
@@ -82,6 +134,7 @@ public:
                   virtual void                 create_framebuffer(const std::string& name, const FramebufferInfo& info) = 0;
     [[nodiscard]]         Material*            create_material(const std::string& name, const MaterialInfo& info);
     [[nodiscard]]         Mesh*                create_mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer);
+    [[nodiscard]]         Mesh*                create_mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer, const MeshRange& range);
     [[nodiscard]] virtual Pipeline*            create_pipeline(const std::string& name, const PipelineInfo& info) = 0;
     [[nodiscard]] virtual PipelineLayout*      create_pipeline_layout(const std::string& name, const PipelineLayoutInfo& info) = 0;
     [[nodiscard]] virtual RenderPass*          create_render_pass(const std::string& name, const RenderPassInfo& info) = 0;
@@ -111,31 +164,71 @@ public:
                           void                 destroy_view(View* view);
 
 protected:
+    Renderer(void);
     virtual ~Renderer(void);
     virtual void _resize(void) = 0;
 
+    // Applies the latency preset and sizes the per frame data, must run before anything per frame is created
+    void _configure_frame_pacing(const RendInitInfo& init_info);
+
+    [[nodiscard]] DrawItemList& _get_thread_draw_items(void);
+
 protected:
     static constexpr std::string C_BACKBUFFER_NAME = "backbuffer";
 
     Window*                               _window{ nullptr };
-    std::queue<std::function<void(void)>> _pre_render_queue;
+
+    // Commands are added to one stream while the other is processed, so commands added while processing wait a frame
+    PreRenderCommandStream                _pre_render_commands;
+    PreRenderCommandStream                _pre_render_commands_processing;
 
     uint32_t                             _frame_counter { 0 };
     uint32_t                             _current_frame{ 0 };
-    static const uint32_t                _FRAMES_IN_FLIGHT { 2 };
+    static constexpr uint32_t            _FRAMES_IN_FLIGHT_MIN{ 1 };
+    static constexpr uint32_t            _FRAMES_IN_FLIGHT_MAX{ 4 };
+    uint32_t                             _frames_in_flight{ 2 };
+    uint32_t                             _swapchain_images{ 3 };
+    PresentMode                          _present_mode{ PresentMode::MAILBOX };
     PresentationMode _presentation_mode{ PresentationMode::DOUBLE_BUFFERING };
-    std::array<FrameData, _FRAMES_IN_FLIGHT> _frame_datas;
+    std::vector<FrameData> _frame_datas;
     bool _need_resize{ false };
+    bool _indirect_draws{ false };
+    CommandBufferStats _command_buffer_stats{};
+    CullStats _cull_stats{};
+    std::vector<GPUPassTiming> _gpu_pass_timings;
+    size_t _transient_bytes{ 0 };
+    TransientAllocator* _transient_allocator{ nullptr };
+    float _lod_error_threshold{ 1.0f };
+
+    // Handle indices from these are packed into draw sort keys, so each holds no more than its key field can
+    static constexpr uint32_t _MESHES_MAX{ 1024 };
+    static constexpr uint32_t _RENDER_STRATEGIES_MAX{ 1 << C_SORT_KEY_RENDER_STRATEGY_BITS };
+    static constexpr uint32_t _VIEWS_MAX{ 1 << C_SORT_KEY_VIEW_BITS };
+    static_assert(_MESHES_MAX <= (1u << C_SORT_KEY_MESH_BITS), "Mesh handles must fit in the draw sort key");
+    static_assert(_RENDER_STRATEGIES_MAX <= (1u << C_SORT_KEY_RENDER_STRATEGY_BITS), "Render strategy handles must fit in the draw sort key");
+    static_assert(_VIEWS_MAX <= (1u << C_SORT_KEY_VIEW_BITS), "View handles must fit in the draw sort key");
 
     //DataArray<DrawPass> _draw_passes;
     DataArray<Material> _materials;
-    DataArray<Mesh> _meshes;
-    DataArray<RenderStrategy> _render_strategies;
+    DataArray<Mesh> _meshes{ _MESHES_MAX };
+    DataArray<RenderStrategy> _render_strategies{ _RENDER_STRATEGIES_MAX };
     DataArray<ShaderSet> _shader_sets;
     //DataArray<SubPass> _sub_passes;
-    DataArray<View> _views;
-
-    std::vector<DrawItem> _draw_items;
+    DataArray<View> _views{ _VIEWS_MAX };
+
+    // One list per thread that has submitted draw items, the lists are cleared each frame but kept
+    std::vector<DrawItemList*> _draw_item_lists;
+    std::mutex                 _draw_item_lists_mutex;
+    uint64_t                   _renderer_id{ 0 }; // Tells apart lists cached by threads for earlier renderers
+
+    static constexpr uint32_t _RETAINED_DRAW_ITEMS_MAX{ 65536 };
+    static constexpr uint8_t  _RETAINED_DRAW_ITEM_DIRTY{ 1 << 0 }; // Needs a new sort entry
+    static constexpr uint8_t  _RETAINED_DRAW_ITEM_STALE{ 1 << 1 }; // Existing sort entry must be dropped
+    DataArray<uint32_t>     _retained_draw_item_handles{ _RETAINED_DRAW_ITEMS_MAX }; // Holds the item's slot in _retained_draw_items
+    DrawItemList            _retained_draw_items;
+    std::vector<uint8_t>    _retained_draw_item_flags;
+    std::vector<RendHandle> _retained_dirty_handles;
+    uint32_t                _retained_stale_count{ 0 };
 
     static Renderer* _renderer;
 };
@@ -25,8 +25,9 @@ struct ShaderSetInfo
     std::vector<VertexBindingInfo> binding_info;
     //std::vector<VertexAttributeInfo>                             vertex_attribute_infos;
     //std::array<std::vector<DescriptorSetLayoutBinding>, DESCRIPTOR_FREQUENCY_COUNT> layout_bindings;
-    std::array<DescriptorSetLayout*, DESCRIPTOR_FREQUENCY_COUNT> layouts;
+    std::array<DescriptorSetLayout*, DESCRIPTOR_FREQUENCY_COUNT> layouts{};
     std::vector<PushConstantRange> push_constant_ranges;
+    uint32_t instance_data_stride{ 0 }; // Array stride of the instance data struct the DRAW set's buffer holds
 
 };
 
@@ -39,7 +40,9 @@ public:
     [[nodiscard]] const Shader* get_shader(ShaderIndex index) const;
     [[nodiscard]] const PipelineLayout& get_pipeline_layout(void) const;
     [[nodiscard]] const DescriptorSetLayout& get_descriptor_set_layout(DescriptorFrequency freq) const;
+    [[nodiscard]] bool has_descriptor_set_layout(DescriptorFrequency freq) const;
     [[nodiscard]] const std::vector<VertexBindingInfo>& get_vertex_bindings(void) const;
+    [[nodiscard]] uint32_t get_instance_data_stride(void) const;
 
 private:
     ShaderSetInfo   _info{};
@@ -0,0 +1,84 @@
+#ifndef REND_CORE_TRANSIENT_ALLOCATOR_H
+#define REND_CORE_TRANSIENT_ALLOCATOR_H
+
+#include "core/containers/ring_buffer.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rend
+{
+
+class GPUBuffer;
+
+enum class TransientUsage : uint32_t
+{
+    UNIFORM,
+    STORAGE,
+    VERTEX,
+    INDEX,
+    COUNT
+};
+
+// A slice of one frame's transient memory. Uniform and storage slices are bound through UNIFORM_BUFFER_DYNAMIC or
+// STORAGE_BUFFER_DYNAMIC descriptors on buffer, with offset as the dynamic offset. Vertex and index slices are bound at offset.
+struct TransientAllocation
+{
+    void*      data{ nullptr };
+    GPUBuffer* buffer{ nullptr };
+    uint32_t   offset{ 0 };
+    uint32_t   bytes{ 0 };
+};
+
+// Hands out slices of one persistently mapped buffer, split into a region per frame in flight. A frame bumps through
+// its own region, which is only reused once that frame in flight comes round again, so slices are never freed and
+// their data needs no staging copy. Allocating is safe from any thread.
+class TransientAllocator
+{
+public:
+    using Alignments = std::array<uint32_t, static_cast<size_t>(TransientUsage::COUNT)>;
+
+    // The largest minimum offset alignment the API may ask for, regions start on it
+    static constexpr uint32_t C_REGION_ALIGNMENT{ 256 };
+
+    // Alignments are indexed by TransientUsage, powers of two no larger than C_REGION_ALIGNMENT
+    TransientAllocator(GPUBuffer& buffer, void* mapped, uint32_t frames_in_flight, const Alignments& alignments);
+    ~TransientAllocator(void) = default;
+    TransientAllocator(const TransientAllocator&)            = delete;
+    TransientAllocator(TransientAllocator&&)                 = delete;
+    TransientAllocator& operator=(const TransientAllocator&) = delete;
+    TransientAllocator& operator=(TransientAllocator&&)      = delete;
+
+    // Bytes the buffer needs to give every frame in flight a region of region_bytes
+    [[nodiscard]] static size_t buffer_bytes(size_t region_bytes, uint32_t frames_in_flight);
+
+    // Moves on to the next frame's region, call once its previous frame's GPU work has completed
+    void start_frame(void);
+
+    // Data is null once the frame's region is full
+    [[nodiscard]] TransientAllocation allocate(TransientUsage usage, size_t bytes);
+
+    [[nodiscard]] GPUBuffer& buffer(void) const;
+    [[nodiscard]] uint32_t   region_bytes(void) const;
+    [[nodiscard]] uint32_t bytes_used(void) const;
+
+private:
+    struct Region
+    {
+        uint32_t begin{ 0 };
+    };
+
+private:
+    GPUBuffer&            _buffer;
+    char*                 _mapped{ nullptr };
+    Alignments            _alignments{};
+    uint32_t              _region_bytes{ 0 };
+    RingBuffer<Region>    _regions;
+    std::atomic<uint32_t> _head{ 0 };   // Bytes used in the current region
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "core/bounds.h"
 #include "core/descriptor_set_binding.h"
 #include "core/gpu_resource.h"
 #include "core/rend_object.h"
@@ -17,6 +18,11 @@ struct ViewInfo
 {
     DescriptorSetLayout* descriptor_set_layout{ nullptr };
     std::vector<DescriptorSetBinding> descriptors;
+
+    // Constants such as the camera's, bound at constants_slot as a UNIFORM_BUFFER_DYNAMIC descriptor and copied into
+    // transient memory each frame. Zero bytes leaves the view without any.
+    uint32_t constants_slot{ 0 };
+    uint32_t constants_bytes{ 0 };
 };
 
 class View : public GPUResource, public RendObject
@@ -28,9 +34,31 @@ class View : public GPUResource, public RendObject
         ViewInfo& get_view_info(void);
         DescriptorSet& get_descriptor_set(void);
 
+        // Bytes must be the view's constants_bytes. Kept until set again.
+        void set_constants(const void* data, size_t bytes);
+
+        // Copies the constants into this frame's transient memory, the renderer calls it each frame before drawing
+        void write_constants(void);
+
+        // Draw items are only culled against views that have been given a frustum
+        void           set_view_projection(const glm::mat4& view_projection);
+        const Frustum* get_frustum(void) const;
+
+        // Meshes are only drawn at lower detail in views that know where they are seen from.
+        // Projection scale is viewport height / (2 * tan(fov_y / 2)), the pixels one unit covers at distance one.
+        void             set_lod_projection(const glm::vec3& eye_position, float projection_scale);
+        bool             has_lod_projection(void) const;
+        const glm::vec3& get_eye_position(void) const;
+        float            get_projection_scale(void) const;
+
     private:
         ViewInfo _info;
         DescriptorSet* _descriptor_set{ nullptr };
+        Frustum _frustum{};
+        bool    _has_frustum{ false };
+        glm::vec3 _eye_position{ 0.0f };
+        float     _projection_scale{ 0.0f };
+        std::vector<char> _constants;
 };
 
 }
@@ -1,2 +1,3 @@
 glslangValidator -V light.vert -o light.vert.spv
+glslangValidator -V light_instanced.vert -o light_instanced.vert.spv
 glslangValidator -V light.frag -o light.frag.spv
@@ -10,6 +10,7 @@ PhysicalDeviceFeatures PhysicalDeviceFeatures::make_device_features(const std::v
     device_features.vk_1_0_features = vulkan_helpers::gen_vk_1_0_features();
     device_features.vk_1_1_features = vulkan_helpers::gen_vk_1_1_features();
     device_features.vk_1_2_features = vulkan_helpers::gen_vk_1_2_features();
+    device_features.vk_1_3_features = vulkan_helpers::gen_vk_1_3_features();
 
     for(auto feature : features)
     {
@@ -362,6 +363,9 @@ PhysicalDeviceFeatures PhysicalDeviceFeatures::make_device_features(const std::v
             case rend::DeviceFeature::SUBGROUP_BROADCAST_DYNAMIC_ID:
                device_features.vk_1_2_features.subgroupBroadcastDynamicId = true;
                break;
+            case rend::DeviceFeature::SYNCHRONIZATION_2:
+               device_features.vk_1_3_features.synchronization2 = true;
+               break;
         }
     }
 
@@ -1,6 +1,7 @@
 #include "api/vulkan/logical_device.h"
 
 #include "core/command_buffer.h"
+#include "core/profiler.h"
 
 #include "api/vulkan/extensions.h"
 #include "api/vulkan/fence.h"
@@ -47,7 +48,8 @@ LogicalDevice::LogicalDevice(const PhysicalDevice* physical_device, const QueueF
 
     PhysicalDeviceFeatures device_features = PhysicalDeviceFeatures::make_device_features(features);
     device_features.vk_1_1_features.pNext = &device_features.vk_1_2_features;
-    device_features.vk_1_2_features.pNext = nullptr;
+    device_features.vk_1_2_features.pNext = &device_features.vk_1_3_features;
+    device_features.vk_1_3_features.pNext = nullptr;
 
     VkPhysicalDeviceFeatures2 vk_device_features_2;
     vk_device_features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
@@ -121,38 +123,71 @@ const PhysicalDevice& LogicalDevice::get_physical_device(void) const
     return *_physical_device;
 }
 
-bool LogicalDevice::queue_submit(VkCommandBuffer* command_buffers, uint32_t command_buffers_count, QueueType type, const std::vector<Semaphore*>& wait_sems, const std::vector<Semaphore*>& signal_sems, const Fence* fence)
+bool LogicalDevice::queue_submit(VkCommandBuffer* command_buffers, uint32_t command_buffers_count, QueueType type, const std::vector<Semaphore*>& wait_sems, const std::vector<Semaphore*>& signal_sems, const std::vector<TimelinePoint>& timeline_waits, const std::vector<TimelinePoint>& timeline_signals, const Fence* fence)
 {
+    REND_PROFILE_ZONE("queue_submit");
     //std::vector<VkCommandBuffer> vk_command_buffers;
     std::vector<VkSemaphore>     vk_wait_sems;
     std::vector<VkSemaphore>     vk_sig_sems;
     std::vector<VkPipelineStageFlags> vk_wait_stages;
+    std::vector<uint64_t>        vk_wait_values;
+    std::vector<uint64_t>        vk_sig_values;
 
     //vk_command_buffers.reserve(command_buffers.size());
-    vk_wait_sems.reserve(wait_sems.size());
-    vk_wait_stages.reserve(wait_sems.size());
-    vk_sig_sems.reserve(signal_sems.size());
+    vk_wait_sems.reserve(wait_sems.size() + timeline_waits.size());
+    vk_wait_stages.reserve(wait_sems.size() + timeline_waits.size());
+    vk_wait_values.reserve(wait_sems.size() + timeline_waits.size());
+    vk_sig_sems.reserve(signal_sems.size() + timeline_signals.size());
+    vk_sig_values.reserve(signal_sems.size() + timeline_signals.size());
 
     //for(CommandBuffer* buf : command_buffers)
     //{
     //    vk_command_buffers.push_back(   );
     //}
 
+    // Binary semaphores ignore their value, but the value arrays must line up with the semaphore arrays
     for(Semaphore* sem : wait_sems)
     {
         vk_wait_sems.push_back(sem->vk_handle());
         vk_wait_stages.push_back(sem->get_wait_stages());
+        vk_wait_values.push_back(0);
+    }
+
+    for(const TimelinePoint& point : timeline_waits)
+    {
+        vk_wait_sems.push_back(point.semaphore->vk_handle());
+        vk_wait_stages.push_back(point.wait_stages);
+        vk_wait_values.push_back(point.value);
     }
 
     for(Semaphore* sem : signal_sems)
     {
         vk_sig_sems.push_back(sem->vk_handle());
+        vk_sig_values.push_back(0);
+    }
+
+    for(const TimelinePoint& point : timeline_signals)
+    {
+        vk_sig_sems.push_back(point.semaphore->vk_handle());
+        vk_sig_values.push_back(point.value);
     }
 
+    VkTimelineSemaphoreSubmitInfo timeline_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext = nullptr,
+        .waitSemaphoreValueCount = static_cast<uint32_t>(vk_wait_values.size()),
+        .pWaitSemaphoreValues = vk_wait_values.data(),
+        .signalSemaphoreValueCount = static_cast<uint32_t>(vk_sig_values.size()),
+        .pSignalSemaphoreValues = vk_sig_values.data()
+    };
+
+    const bool has_timeline = !timeline_waits.empty() || !timeline_signals.empty();
+
     VkSubmitInfo submit_info =
     {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext = nullptr,
+        .pNext = has_timeline ? &timeline_info : nullptr,
         .waitSemaphoreCount = static_cast<uint32_t>(vk_wait_sems.size()),
         .pWaitSemaphores = vk_wait_sems.data(),
         .pWaitDstStageMask = vk_wait_stages.data(),
@@ -205,6 +240,28 @@ void LogicalDevice::reset_fences(std::vector<VkFence>& fences)
     vkResetFences(_vk_device, fences.size(), fences.data());
 }
 
+VkResult LogicalDevice::wait_semaphore(VkSemaphore semaphore, uint64_t value, uint64_t timeout)
+{
+    VkSemaphoreWaitInfo wait_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .semaphoreCount = 1,
+        .pSemaphores = &semaphore,
+        .pValues = &value
+    };
+
+    return vkWaitSemaphores(_vk_device, &wait_info, timeout);
+}
+
+uint64_t LogicalDevice::get_semaphore_counter_value(VkSemaphore semaphore)
+{
+    uint64_t value{ 0 };
+    vkGetSemaphoreCounterValue(_vk_device, semaphore, &value);
+    return value;
+}
+
 VkResult LogicalDevice::acquire_next_image(Swapchain* swapchain, uint64_t timeout, Semaphore* semaphore, Fence* fence, uint32_t* image_index)
 {
     return vkAcquireNextImageKHR(
@@ -265,9 +322,9 @@ VkMemoryRequirements LogicalDevice::get_buffer_memory_reqs(VkBuffer buffer)
     return memory_reqs;
 }
 
-VkResult LogicalDevice::bind_buffer_memory(VkBuffer buffer, VkDeviceMemory memory)
+VkResult LogicalDevice::bind_buffer_memory(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset)
 {
-    return vkBindBufferMemory(_vk_device, buffer, memory, 0);
+    return vkBindBufferMemory(_vk_device, buffer, memory, offset);
 }
 
 VkMemoryRequirements LogicalDevice::get_image_memory_reqs(VkImage image)
@@ -277,9 +334,9 @@ VkMemoryRequirements LogicalDevice::get_image_memory_reqs(VkImage image)
     return memory_reqs;
 }
 
-VkResult LogicalDevice::bind_image_memory(VkImage image, VkDeviceMemory memory)
+VkResult LogicalDevice::bind_image_memory(VkImage image, VkDeviceMemory memory, VkDeviceSize offset)
 {
-    return vkBindImageMemory(_vk_device, image, memory, 0);
+    return vkBindImageMemory(_vk_device, image, memory, offset);
 }
 
 std::vector<VkDescriptorSet> LogicalDevice::allocate_descriptor_sets(std::vector<VkDescriptorSetLayout>& layouts, VkDescriptorPool pool)
@@ -357,6 +414,18 @@ void LogicalDevice::unmap_memory(VkDeviceMemory memory)
     vkUnmapMemory(_vk_device, memory);
 }
 
+bool LogicalDevice::flush_memory(const VkMappedMemoryRange& range)
+{
+    auto code = vkFlushMappedMemoryRanges(_vk_device, 1, &range);
+    return code == VK_SUCCESS;
+}
+
+bool LogicalDevice::invalidate_memory(const VkMappedMemoryRange& range)
+{
+    auto code = vkInvalidateMappedMemoryRanges(_vk_device, 1, &range);
+    return code == VK_SUCCESS;
+}
+
 VkSwapchainKHR LogicalDevice::create_swapchain(VkSwapchainCreateInfoKHR& create_info)
 {
     VkSwapchainKHR swapchain = VK_NULL_HANDLE;
@@ -494,6 +563,23 @@ void LogicalDevice::destroy_event(VkEvent event)
     vkDestroyEvent(_vk_device, event, nullptr);
 }
 
+VkQueryPool LogicalDevice::create_query_pool(const VkQueryPoolCreateInfo& create_info)
+{
+    VkQueryPool query_pool = VK_NULL_HANDLE;
+    vkCreateQueryPool(_vk_device, &create_info, nullptr, &query_pool);
+    return query_pool;
+}
+
+void LogicalDevice::destroy_query_pool(VkQueryPool query_pool)
+{
+    vkDestroyQueryPool(_vk_device, query_pool, nullptr);
+}
+
+VkResult LogicalDevice::get_query_pool_results(VkQueryPool query_pool, uint32_t first_query, uint32_t queries_count, size_t size_bytes, void* data, VkDeviceSize stride_bytes, VkQueryResultFlags flags)
+{
+    return vkGetQueryPoolResults(_vk_device, query_pool, first_query, queries_count, size_bytes, data, stride_bytes, flags);
+}
+
 VkFence LogicalDevice::create_fence(const VkFenceCreateInfo& create_info)
 {
     VkFence fence = VK_NULL_HANDLE;
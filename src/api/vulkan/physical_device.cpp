@@ -8,6 +8,7 @@
 #include "api/vulkan/device_features.h"
 #include "api/vulkan/vulkan_instance.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace rend;
@@ -33,7 +34,7 @@ PhysicalDevice::~PhysicalDevice(void)
 LogicalDevice* PhysicalDevice::create_logical_device(const VkQueueFlags queue_flags, const std::vector<DeviceFeature>& desired_features)
 {
     QueueFamily* graphics_family = nullptr;
-    QueueFamily* present_family = nullptr;
+    QueueFamily* transfer_family = nullptr;
 
     if(queue_flags & VK_QUEUE_GRAPHICS_BIT)
     {
@@ -42,11 +43,12 @@ LogicalDevice* PhysicalDevice::create_logical_device(const VkQueueFlags queue_fl
             return nullptr;
         }
 
+        // Uploads share the graphics queue when there is no separate transfer family
         graphics_family = _graphics_queue_families[0];
-        present_family  = _present_queue_families[0];
+        transfer_family = !_transfer_queue_families.empty() ? _transfer_queue_families[0] : graphics_family;
     }
 
-    LogicalDevice* logical_device = new LogicalDevice(this, graphics_family, present_family, desired_features);
+    LogicalDevice* logical_device = new LogicalDevice(this, graphics_family, transfer_family, desired_features);
 
     return logical_device;
 }
@@ -84,6 +86,11 @@ const VkPhysicalDeviceMemoryProperties& PhysicalDevice::get_memory_properties(vo
     return _vk_physical_device_memory_properties;
 }
 
+const VkPhysicalDeviceProperties& PhysicalDevice::get_properties(void) const
+{
+    return _vk_physical_device_properties;
+}
+
 bool PhysicalDevice::has_queues(VkQueueFlags queue_flags) const
 {
     const bool has_graphics_queue = (queue_flags & VK_QUEUE_GRAPHICS_BIT) ? !_graphics_queue_families.empty()  : true;
@@ -98,7 +105,8 @@ bool PhysicalDevice::has_features(const std::vector<DeviceFeature>& desired_feat
 
     PhysicalDeviceFeatures check_features = PhysicalDeviceFeatures::make_device_features({});
     check_features.vk_1_1_features.pNext = &check_features.vk_1_2_features;
-    check_features.vk_1_2_features.pNext = nullptr;
+    check_features.vk_1_2_features.pNext = &check_features.vk_1_3_features;
+    check_features.vk_1_3_features.pNext = nullptr;
 
     VkPhysicalDeviceFeatures2 device_features;
     device_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
@@ -341,6 +349,8 @@ bool PhysicalDevice::has_features(const std::vector<DeviceFeature>& desired_feat
        return false;
     if(!check_features.vk_1_2_features.subgroupBroadcastDynamicId && desired_features_built.vk_1_2_features.subgroupBroadcastDynamicId)
        return false;
+    if(!check_features.vk_1_3_features.synchronization2 && desired_features_built.vk_1_3_features.synchronization2)
+       return false;
 
     return true;
 }
@@ -377,8 +387,21 @@ bool PhysicalDevice::_find_queue_families(VkSurfaceKHR surface)
         {
             _present_queue_families.push_back(queue_family);
         }
+
+        const VkQueueFlags queue_flags = queue_family->get_properties().queueFlags;
+        if((queue_flags & VK_QUEUE_TRANSFER_BIT) && !(queue_flags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            _transfer_queue_families.push_back(queue_family);
+        }
     }
 
+    // Transfer only families are usually the copy engines, prefer those over async compute families
+    std::stable_partition(_transfer_queue_families.begin(), _transfer_queue_families.end(),
+        [](const QueueFamily* queue_family)
+        {
+            return !(queue_family->get_properties().queueFlags & VK_QUEUE_COMPUTE_BIT);
+        });
+
     return true;
 }
 
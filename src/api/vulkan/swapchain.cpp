@@ -9,6 +9,7 @@
 #include "api/vulkan/vulkan_semaphore.h"
 #include "api/vulkan/vulkan_texture.h"
 #include "core/window.h"
+#include "core/profiler.h"
 #include "core/logging/log_defs.h"
 #include "core/logging/log_manager.h"
 #include <cassert>
@@ -28,9 +29,10 @@ namespace
     }
 }
 
-Swapchain::Swapchain(uint32_t desired_images, VulkanDeviceContext& ctx)
+Swapchain::Swapchain(uint32_t desired_images, VkPresentModeKHR desired_present_mode, VulkanDeviceContext& ctx)
     :
         _desired_image_count(desired_images),
+        _desired_present_mode(desired_present_mode),
         _ctx(&ctx)
 {
     _create();
@@ -86,6 +88,7 @@ const SwapchainPresent& Swapchain::get_present_resources(const SwapchainAcquire&
 
 StatusCode Swapchain::acquire(SwapchainAcquire& acquire_resource)
 {
+    REND_PROFILE_ZONE("swapchain_acquire");
     VkResult result = _ctx->get_device()->acquire_next_image(
         this, std::numeric_limits<uint64_t>::max(), acquire_resource.acquire_semaphore, nullptr, &_image_idx
     );
@@ -113,6 +116,7 @@ StatusCode Swapchain::acquire(SwapchainAcquire& acquire_resource)
 
 StatusCode Swapchain::present(QueueType type /*, const std::vector<Semaphore*>& wait_sems*/)
 {
+    REND_PROFILE_ZONE("swapchain_present");
     std::vector<VkResult> results(1);
 
 #if DEBUG
@@ -151,7 +155,7 @@ StatusCode Swapchain::_create(void)
     }
 
     _surface_format = _find_surface_format(physical_device.get_surface_formats());
-    auto present_mode = _find_present_mode(physical_device.get_surface_present_modes());
+    auto present_mode = _find_present_mode(_desired_present_mode, physical_device.get_surface_present_modes());
     auto found_image_count = _find_image_count(_desired_image_count, surface_caps);
 
     _vk_extent = surface_caps.currentExtent;
@@ -267,17 +271,18 @@ VkSurfaceFormatKHR Swapchain::_find_surface_format(const std::vector<VkSurfaceFo
     return surface_formats[0];
 }
 
-VkPresentModeKHR Swapchain::_find_present_mode(const std::vector<VkPresentModeKHR>& present_modes)
+VkPresentModeKHR Swapchain::_find_present_mode(VkPresentModeKHR desired_present_mode, const std::vector<VkPresentModeKHR>& present_modes)
 {
+    // FIFO is always supported. Mailbox falls back to immediate first, which keeps its latency but may tear.
     VkPresentModeKHR chosen = VK_PRESENT_MODE_FIFO_KHR;
     for(VkPresentModeKHR present_mode : present_modes)
     {
-        if(present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
+        if(present_mode == desired_present_mode)
         {
             return present_mode;
         }
 
-        if(present_mode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+        if(desired_present_mode == VK_PRESENT_MODE_MAILBOX_KHR && present_mode == VK_PRESENT_MODE_IMMEDIATE_KHR)
         {
             chosen = present_mode;
         }
@@ -324,5 +329,7 @@ void Swapchain::_unregister_swapchain_image(TextureHandle texture_handle)
     core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "SWAPCHAIN | Unregistered swapchain image: " + texture->name());
 #endif
 
+    // Constructed in place by _register_swapchain_image, the pool only destructs what is live when it goes
+    texture->~VulkanTexture();
     _backbuffer_resources.backbuffer_textures.release(texture_handle);
 }
@@ -0,0 +1,55 @@
+#include "api/vulkan/timeline_semaphore.h"
+
+#include "api/vulkan/logical_device.h"
+#include "api/vulkan/vulkan_device_context.h"
+#include "api/vulkan/vulkan_helper_funcs.h"
+#include "core/profiler.h"
+#include "core/logging/log_defs.h"
+#include "core/logging/log_manager.h"
+
+using namespace rend;
+
+TimelineSemaphore::TimelineSemaphore(const std::string& name, uint64_t initial_value, VulkanDeviceContext& ctx)
+    :
+        _name(name),
+        _ctx(&ctx)
+{
+    VkSemaphoreTypeCreateInfo type_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext = nullptr,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = initial_value
+    };
+
+    VkSemaphoreCreateInfo create_info = vulkan_helpers::gen_semaphore_create_info();
+    create_info.pNext = &type_info;
+    _vk_semaphore = _ctx->create_semaphore(create_info);
+
+#if DEBUG
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "TIMELINE SEMAPHORE | Creating timeline semaphore (" + _name + ") with params: { initial value: " + std::to_string(initial_value) + " }");
+    _ctx->set_debug_name(name, VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)_vk_semaphore);
+#endif
+}
+
+TimelineSemaphore::~TimelineSemaphore(void)
+{
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "TIMELINE SEMAPHORE | Destroying timeline semaphore (" + _name + ")");
+    _ctx->destroy_semaphore(_vk_semaphore);
+}
+
+VkSemaphore TimelineSemaphore::vk_handle(void) const
+{
+    return _vk_semaphore;
+}
+
+uint64_t TimelineSemaphore::get_value(void) const
+{
+    return _ctx->get_device()->get_semaphore_counter_value(_vk_semaphore);
+}
+
+VkResult TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+{
+    REND_PROFILE_ZONE("timeline_wait");
+    return _ctx->get_device()->wait_semaphore(_vk_semaphore, value, timeout);
+}
@@ -0,0 +1,277 @@
+#include "api/vulkan/vulkan_barrier_batch.h"
+
+#include "api/vulkan/vulkan_command_buffer.h"
+#include "api/vulkan/vulkan_helper_funcs.h"
+#include "api/vulkan/vulkan_texture.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace rend;
+
+namespace
+{
+    // Only writes have to be made available, earlier reads just need to finish
+    constexpr VkAccessFlags2 C_WRITE_ACCESSES =
+        VK_ACCESS_2_SHADER_WRITE_BIT |
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_2_TRANSFER_WRITE_BIT |
+        VK_ACCESS_2_HOST_WRITE_BIT |
+        VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+    bool ranges_overlap(const VkImageSubresourceRange& lhs, const VkImageSubresourceRange& rhs)
+    {
+        return lhs.baseMipLevel   < rhs.baseMipLevel + rhs.levelCount     && rhs.baseMipLevel   < lhs.baseMipLevel + lhs.levelCount &&
+               lhs.baseArrayLayer < rhs.baseArrayLayer + rhs.layerCount && rhs.baseArrayLayer < lhs.baseArrayLayer + lhs.layerCount;
+    }
+
+    bool same_barrier_state(const VkImageMemoryBarrier2& lhs, const VkImageMemoryBarrier2& rhs)
+    {
+        return lhs.image         == rhs.image         &&
+               lhs.srcStageMask  == rhs.srcStageMask  && lhs.srcAccessMask == rhs.srcAccessMask &&
+               lhs.dstStageMask  == rhs.dstStageMask  && lhs.dstAccessMask == rhs.dstAccessMask &&
+               lhs.oldLayout     == rhs.oldLayout     && lhs.newLayout     == rhs.newLayout &&
+               lhs.srcQueueFamilyIndex == rhs.srcQueueFamilyIndex && lhs.dstQueueFamilyIndex == rhs.dstQueueFamilyIndex;
+    }
+}
+
+void VulkanBarrierBatch::transition(VulkanTexture& texture, const VulkanImageTransition& transition)
+{
+    const uint32_t mips_end   = transition.mips_count == VK_REMAINING_MIP_LEVELS ? texture.subresource_mips() : transition.base_mip + transition.mips_count;
+    const uint32_t layers_end = transition.layers_count == VK_REMAINING_ARRAY_LAYERS ? texture.subresource_layers() : transition.base_layer + transition.layers_count;
+    assert(mips_end <= texture.subresource_mips() && layers_end <= texture.subresource_layers());
+
+    const bool transfers_ownership = transition.src_queue_family != transition.dst_queue_family;
+    const bool adds_write = (transition.accesses & C_WRITE_ACCESSES) || transition.src_stages != VK_PIPELINE_STAGE_2_NONE;
+
+    VkImageMemoryBarrier2 barrier =
+    {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .pNext               = nullptr,
+        .srcStageMask        = VK_PIPELINE_STAGE_2_NONE,
+        .srcAccessMask       = VK_ACCESS_2_NONE,
+        .dstStageMask        = transition.stages,
+        .dstAccessMask       = transition.accesses,
+        .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout           = transition.layout,
+        .srcQueueFamilyIndex = transition.src_queue_family,
+        .dstQueueFamilyIndex = transition.dst_queue_family,
+        .image               = texture.vk_image_info().image,
+        .subresourceRange    =
+        {
+            .aspectMask     = vulkan_helpers::find_image_aspects(vulkan_helpers::convert_format(texture.format())),
+            .baseMipLevel   = 0,
+            .levelCount     = 0,
+            .baseArrayLayer = 0,
+            .layerCount     = 1
+        }
+    };
+
+    for(uint32_t layer = transition.base_layer; layer < layers_end; ++layer)
+    {
+        barrier.subresourceRange.baseArrayLayer = layer;
+        barrier.subresourceRange.levelCount     = 0;
+
+        for(uint32_t mip = transition.base_mip; mip < mips_end; ++mip)
+        {
+            VulkanSubresourceState state = texture.get_subresource_state(mip, layer);
+
+            // Another read of a layout nothing has written to since its last barrier
+            const bool was_written = state.accesses & C_WRITE_ACCESSES;
+            if(!transition.discard && !transfers_ownership && !adds_write && !was_written && state.layout == transition.layout)
+            {
+                if(barrier.subresourceRange.levelCount > 0)
+                {
+                    _add_image_barrier(barrier);
+                    barrier.subresourceRange.levelCount = 0;
+                }
+
+                state.stages   |= transition.stages;
+                state.accesses |= transition.accesses;
+                texture.set_subresource_state(mip, layer, state);
+                _widen_pending_barrier(barrier.image, mip, layer, transition.stages, transition.accesses);
+                continue;
+            }
+
+            const VkPipelineStageFlags2 src_stages   = state.stages | transition.src_stages;
+            const VkAccessFlags2        src_accesses = (state.accesses & C_WRITE_ACCESSES) | transition.src_accesses;
+            const VkImageLayout         old_layout   = transition.discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+
+            // Neighbouring mips leaving the same state share a barrier
+            if(barrier.subresourceRange.levelCount > 0 &&
+               (barrier.srcStageMask != src_stages || barrier.srcAccessMask != src_accesses || barrier.oldLayout != old_layout))
+            {
+                _add_image_barrier(barrier);
+                barrier.subresourceRange.levelCount = 0;
+            }
+
+            if(barrier.subresourceRange.levelCount == 0)
+            {
+                barrier.srcStageMask                  = src_stages;
+                barrier.srcAccessMask                 = src_accesses;
+                barrier.oldLayout                     = old_layout;
+                barrier.subresourceRange.baseMipLevel = mip;
+            }
+
+            ++barrier.subresourceRange.levelCount;
+            texture.set_subresource_state(mip, layer, { transition.layout, transition.stages, transition.accesses });
+        }
+
+        if(barrier.subresourceRange.levelCount > 0)
+        {
+            _add_image_barrier(barrier);
+        }
+    }
+
+    if(transition.base_mip == 0 && mips_end == texture.subresource_mips() && transition.base_layer == 0 && layers_end == texture.subresource_layers())
+    {
+        texture.layout(vulkan_helpers::convert_image_layout(transition.layout));
+    }
+}
+
+void VulkanBarrierBatch::barrier(const VkImageMemoryBarrier2& barrier)
+{
+    _image_barriers.push_back(barrier);
+}
+
+void VulkanBarrierBatch::barrier(const VkBufferMemoryBarrier2& barrier)
+{
+    _buffer_barriers.push_back(barrier);
+}
+
+void VulkanBarrierBatch::flush(VulkanCommandBuffer& command_buffer)
+{
+    if(empty())
+    {
+        return;
+    }
+
+    // Pending barriers cover one layer each so transitions can retarget them, layers whose mips share a barrier
+    // usually do for the next layer too
+    size_t merged_count = 0;
+    for(size_t idx = 0; idx < _image_barriers.size(); ++idx)
+    {
+        if(merged_count > 0)
+        {
+            VkImageMemoryBarrier2& last = _image_barriers[merged_count - 1];
+            const VkImageMemoryBarrier2& next = _image_barriers[idx];
+            if(same_barrier_state(last, next) &&
+               last.subresourceRange.baseMipLevel == next.subresourceRange.baseMipLevel &&
+               last.subresourceRange.levelCount == next.subresourceRange.levelCount &&
+               last.subresourceRange.baseArrayLayer + last.subresourceRange.layerCount == next.subresourceRange.baseArrayLayer)
+            {
+                last.subresourceRange.layerCount += next.subresourceRange.layerCount;
+                continue;
+            }
+        }
+
+        _image_barriers[merged_count++] = _image_barriers[idx];
+    }
+
+    _image_barriers.resize(merged_count);
+
+    command_buffer.pipeline_barrier(_buffer_barriers, _image_barriers);
+    clear();
+}
+
+void VulkanBarrierBatch::clear(void)
+{
+    _image_barriers.clear();
+    _buffer_barriers.clear();
+}
+
+bool VulkanBarrierBatch::empty(void) const
+{
+    return _image_barriers.empty() && _buffer_barriers.empty();
+}
+
+void VulkanBarrierBatch::_widen_pending_barrier(VkImage image, uint32_t mip, uint32_t layer, VkPipelineStageFlags2 stages, VkAccessFlags2 accesses)
+{
+    // The new readers come after the flush as well, so they have to wait on a pending transition too
+    for(VkImageMemoryBarrier2& pending : _image_barriers)
+    {
+        const VkImageSubresourceRange& range = pending.subresourceRange;
+        if(pending.image == image && range.baseArrayLayer == layer && range.baseMipLevel <= mip && mip < range.baseMipLevel + range.levelCount)
+        {
+            pending.dstStageMask  |= stages;
+            pending.dstAccessMask |= accesses;
+            return;
+        }
+    }
+}
+
+void VulkanBarrierBatch::_add_image_barrier(const VkImageMemoryBarrier2& barrier)
+{
+    assert(barrier.subresourceRange.layerCount == 1);
+
+    // Mips of the new barrier without a barrier pending, begin and end pairs
+    std::vector<std::pair<uint32_t, uint32_t>> uncovered{ { barrier.subresourceRange.baseMipLevel, barrier.subresourceRange.baseMipLevel + barrier.subresourceRange.levelCount } };
+
+    const size_t pending_count = _image_barriers.size();
+    for(size_t idx = 0; idx < pending_count; ++idx)
+    {
+        VkImageMemoryBarrier2 pending = _image_barriers[idx];
+        if(pending.image != barrier.image || !ranges_overlap(pending.subresourceRange, barrier.subresourceRange))
+        {
+            continue;
+        }
+
+        assert(pending.srcQueueFamilyIndex == pending.dstQueueFamilyIndex && "Flush before transitioning a released texture");
+
+        const uint32_t pending_begin = pending.subresourceRange.baseMipLevel;
+        const uint32_t pending_end   = pending_begin + pending.subresourceRange.levelCount;
+        const uint32_t overlap_begin = std::max(pending_begin, barrier.subresourceRange.baseMipLevel);
+        const uint32_t overlap_end   = std::min(pending_end, barrier.subresourceRange.baseMipLevel + barrier.subresourceRange.levelCount);
+
+        // Nothing runs between the two, so the overlap goes straight from the pending barrier's old state to the new one
+        _image_barriers[idx].subresourceRange.baseMipLevel = overlap_begin;
+        _image_barriers[idx].subresourceRange.levelCount   = overlap_end - overlap_begin;
+        _image_barriers[idx].newLayout                     = barrier.newLayout;
+        _image_barriers[idx].dstStageMask                  = barrier.dstStageMask;
+        _image_barriers[idx].dstAccessMask                 = barrier.dstAccessMask;
+        _image_barriers[idx].srcQueueFamilyIndex           = barrier.srcQueueFamilyIndex;
+        _image_barriers[idx].dstQueueFamilyIndex           = barrier.dstQueueFamilyIndex;
+
+        // Whatever of the pending range is outside the overlap keeps its barrier
+        if(pending_begin < overlap_begin)
+        {
+            pending.subresourceRange.baseMipLevel = pending_begin;
+            pending.subresourceRange.levelCount   = overlap_begin - pending_begin;
+            _image_barriers.push_back(pending);
+        }
+
+        if(overlap_end < pending_end)
+        {
+            pending.subresourceRange.baseMipLevel = overlap_end;
+            pending.subresourceRange.levelCount   = pending_end - overlap_end;
+            _image_barriers.push_back(pending);
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> remaining;
+        for(auto [begin, end] : uncovered)
+        {
+            if(begin < overlap_begin)
+            {
+                remaining.push_back({ begin, std::min(end, overlap_begin) });
+            }
+
+            if(end > overlap_end)
+            {
+                remaining.push_back({ std::max(begin, overlap_end), end });
+            }
+        }
+
+        uncovered.swap(remaining);
+    }
+
+    VkImageMemoryBarrier2 uncovered_barrier = barrier;
+    for(auto [begin, end] : uncovered)
+    {
+        uncovered_barrier.subresourceRange.baseMipLevel = begin;
+        uncovered_barrier.subresourceRange.levelCount   = end - begin;
+        _image_barriers.push_back(uncovered_barrier);
+    }
+}
@@ -13,3 +13,8 @@ const VulkanBufferInfo& VulkanBuffer::vk_buffer_info(void) const
 {
     return _vk_buffer_info;
 }
+
+void* VulkanBuffer::mapped(void) const
+{
+    return _vk_buffer_info.memory.mapped;
+}
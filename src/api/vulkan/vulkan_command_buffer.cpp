@@ -1,9 +1,11 @@
 #include "api/vulkan/vulkan_command_buffer.h"
 
+#include "api/vulkan/vulkan_barrier_batch.h"
 #include "api/vulkan/vulkan_buffer.h"
 #include "api/vulkan/vulkan_descriptor_set.h"
 #include "api/vulkan/vulkan_framebuffer.h"
 #include "api/vulkan/vulkan_helper_funcs.h"
+#include "api/vulkan/vulkan_pass_queries.h"
 #include "api/vulkan/vulkan_pipeline.h"
 #include "api/vulkan/vulkan_pipeline_layout.h"
 #include "api/vulkan/vulkan_render_pass.h"
@@ -22,14 +24,18 @@
 #include "core/logging/log_defs.h"
 #include "core/logging/log_manager.h"
 
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
 #include <iostream>
 
 using namespace rend;
 
-VulkanCommandBuffer::VulkanCommandBuffer(const std::string& name, VkCommandBuffer vk_handle)
+VulkanCommandBuffer::VulkanCommandBuffer(const std::string& name, VkCommandBuffer vk_handle, VkCommandBufferLevel level)
     :
         CommandBuffer(name),
-        _vk_handle(vk_handle)
+        _vk_handle(vk_handle),
+        _level(level)
 {
 }
 
@@ -38,58 +44,133 @@ CommandBufferState VulkanCommandBuffer::get_state(void) const
     return _state;
 }
 
+const CommandBufferStats& VulkanCommandBuffer::get_stats(void) const
+{
+    return _stats;
+}
+
 VkCommandBuffer VulkanCommandBuffer::vk_handle(void) const
 {
     return _vk_handle;
 }
 
-void VulkanCommandBuffer::bind_descriptor_sets(PipelineBindPoint bind_point, const PipelineLayout& pipeline_layout, const std::vector<const DescriptorSet*> descriptor_sets)
+VkCommandBufferLevel VulkanCommandBuffer::level(void) const
 {
-    //TODO: Figure out a good array size
-    const int c_descriptor_set_max = 16;
+    return _level;
+}
 
+void VulkanCommandBuffer::bind_descriptor_sets(PipelineBindPoint bind_point, const PipelineLayout& pipeline_layout, const std::vector<const DescriptorSet*>& descriptor_sets)
+{
     VkPipelineBindPoint vk_bind_point   = vulkan_helpers::convert_pipeline_bind_point(bind_point);
     VkPipelineLayout vk_pipeline_layout = static_cast<const VulkanPipelineLayout&>(pipeline_layout).vk_handle();
 
-    VkDescriptorSet vk_descriptor_sets[c_descriptor_set_max];
-    for(size_t i = 0; i < descriptor_sets.size(); ++i)
+    // Sets bound through a different layout cannot be assumed to still be valid
+    if(vk_pipeline_layout != _bound_descriptor_sets_layout)
+    {
+        _bound_descriptor_sets.fill(VK_NULL_HANDLE);
+        _bound_descriptor_sets_layout = vk_pipeline_layout;
+    }
+
+    uint32_t first_set = descriptor_sets.front()->get_index();
+    uint32_t sets_count = static_cast<uint32_t>(descriptor_sets.size());
+    assert(first_set + sets_count <= constants::max_descriptor_sets);
+
+    VkDescriptorSet vk_descriptor_sets[constants::max_descriptor_sets];
+    for(uint32_t i = 0; i < sets_count; ++i)
     {
         auto& desc_set_info = static_cast<const VulkanDescriptorSet*>(descriptor_sets[i])->vk_set_info();
         vk_descriptor_sets[i] = desc_set_info.set;
     }
 
-    uint32_t first_set = descriptor_sets.front()->get_index();
+    // Trim sets that are already bound off both ends, leaving the contiguous range that changed.
+    // Sets with dynamic offsets are always rebound, their offsets may have moved since.
+    auto is_bound = [&](uint32_t i)
+    {
+        return _bound_descriptor_sets[first_set + i] == vk_descriptor_sets[i] && descriptor_sets[i]->get_dynamic_offsets().empty();
+    };
+
+    uint32_t begin = 0;
+    while(begin < sets_count && is_bound(begin))
+    {
+        ++begin;
+    }
+
+    uint32_t end = sets_count;
+    while(end > begin && is_bound(end - 1))
+    {
+        --end;
+    }
+
+    _stats.descriptor_set_binds_elided += sets_count - (end - begin);
+
+    if(begin == end)
+    {
+        return;
+    }
+
+    for(uint32_t i = begin; i < end; ++i)
+    {
+        _bound_descriptor_sets[first_set + i] = vk_descriptor_sets[i];
+    }
+
+    // Offsets go in the order of the sets, then of the bindings within each
+    _dynamic_offsets.clear();
+    for(uint32_t i = begin; i < end; ++i)
+    {
+        const auto& offsets = descriptor_sets[i]->get_dynamic_offsets();
+        _dynamic_offsets.insert(_dynamic_offsets.end(), offsets.begin(), offsets.end());
+    }
 
-    vkCmdBindDescriptorSets(_vk_handle, vk_bind_point, vk_pipeline_layout, first_set, descriptor_sets.size(), vk_descriptor_sets, 0, nullptr);
+    vkCmdBindDescriptorSets(_vk_handle, vk_bind_point, vk_pipeline_layout, first_set + begin, end - begin, &vk_descriptor_sets[begin], static_cast<uint32_t>(_dynamic_offsets.size()), _dynamic_offsets.data());
 }
 
 void VulkanCommandBuffer::bind_pipeline(PipelineBindPoint bind_point, const Pipeline& pipeline)
 {
     VkPipeline vk_pipeline = static_cast<const VulkanPipeline&>(pipeline).vk_handle();
+    if(vk_pipeline == _bound_pipeline)
+    {
+        ++_stats.pipeline_binds_elided;
+        return;
+    }
+
+    // A pipeline with an incompatible layout disturbs push constants
+    _pushed_constants_layout = VK_NULL_HANDLE;
+    _bound_pipeline = vk_pipeline;
+
     vkCmdBindPipeline(_vk_handle, vulkan_helpers::convert_pipeline_bind_point(bind_point), vk_pipeline);
 }
 
-void VulkanCommandBuffer::bind_vertex_buffer(const GPUBuffer& vertex_buffer)
+void VulkanCommandBuffer::bind_vertex_buffer(const GPUBuffer& vertex_buffer, size_t offset_bytes)
 {
-    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "COMMAND BUFFER | " + name() + " | Binding vertex buffer: " + vertex_buffer.name());
-
     //TODO: Update to bind more than 1 buffer
-    //TODO: Handle non-0 offsets
     //TODO: Handle non-0 first binding
-    VkDeviceSize offset = 0;
+    VkDeviceSize offset = offset_bytes;
     auto& vertex_buffer_info = static_cast<const VulkanBuffer&>(vertex_buffer).vk_buffer_info();
 
+    if(vertex_buffer_info.buffer == _bound_vertex_buffer && offset == _bound_vertex_buffer_offset)
+    {
+        ++_stats.vertex_buffer_binds_elided;
+        return;
+    }
+
+    _bound_vertex_buffer = vertex_buffer_info.buffer;
+    _bound_vertex_buffer_offset = offset;
     vkCmdBindVertexBuffers(_vk_handle, 0, 1, &vertex_buffer_info.buffer, &offset);
 }
 
-void VulkanCommandBuffer::bind_index_buffer(const GPUBuffer& index_buffer)
+void VulkanCommandBuffer::bind_index_buffer(const GPUBuffer& index_buffer, size_t offset_bytes)
 {
-    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "COMMAND BUFFER | " + name() + " | Binding index buffer: " + index_buffer.name());
-
-    //TODO: Handle non-0 offsets
-    VkDeviceSize offset = 0;
+    VkDeviceSize offset = offset_bytes;
     auto& index_buffer_info = static_cast<const VulkanBuffer&>(index_buffer).vk_buffer_info();
 
+    if(index_buffer_info.buffer == _bound_index_buffer && offset == _bound_index_buffer_offset)
+    {
+        ++_stats.index_buffer_binds_elided;
+        return;
+    }
+
+    _bound_index_buffer = index_buffer_info.buffer;
+    _bound_index_buffer_offset = offset;
     vkCmdBindIndexBuffer(_vk_handle, index_buffer_info.buffer, offset, VK_INDEX_TYPE_UINT32);
 }
 
@@ -190,27 +271,85 @@ void VulkanCommandBuffer::copy(const GPUTexture& src, const GPUTexture& dst, con
 
 void VulkanCommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
-    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "COMMAND BUFFER | " + name() + " | Draw");
     vkCmdDraw(_vk_handle, vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void VulkanCommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
-    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "COMMAND BUFFER | " + name() + " | Draw indexed");
     vkCmdDrawIndexed(_vk_handle, index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
+void VulkanCommandBuffer::draw_indexed_indirect(const GPUBuffer& buffer, size_t offset, uint32_t draw_count, uint32_t stride)
+{
+    auto& buffer_info = static_cast<const VulkanBuffer&>(buffer).vk_buffer_info();
+    vkCmdDrawIndexedIndirect(_vk_handle, buffer_info.buffer, offset, draw_count, stride);
+}
+
+void VulkanCommandBuffer::execute_commands(const std::vector<CommandBuffer*>& command_buffers)
+{
+    const size_t c_execute_command_buffers_max = 32;
+
+    VkCommandBuffer vk_command_buffers[c_execute_command_buffers_max];
+    for(size_t first = 0; first < command_buffers.size(); first += c_execute_command_buffers_max)
+    {
+        const size_t count = std::min(command_buffers.size() - first, c_execute_command_buffers_max);
+        for(size_t i = 0; i < count; ++i)
+        {
+            vk_command_buffers[i] = static_cast<const VulkanCommandBuffer*>(command_buffers[first + i])->vk_handle();
+        }
+
+        vkCmdExecuteCommands(_vk_handle, count, vk_command_buffers);
+    }
+
+    // State bound in this command buffer is undefined after executing secondaries
+    _reset_bound_state();
+}
+
 void VulkanCommandBuffer::push_constant(const PipelineLayout& layout, ShaderStages stages, uint32_t offset, size_t size, const void* data)
 {
     VkPipelineLayout vk_layout = static_cast<const VulkanPipelineLayout&>(layout).vk_handle();
     VkShaderStageFlags shader_stage_flags = vulkan_helpers::convert_shader_stages(stages);
+    assert(size <= constants::max_push_constant_bytes);
+
+    if(vk_layout == _pushed_constants_layout &&
+       shader_stage_flags == _pushed_constants_stages &&
+       offset == _pushed_constants_offset &&
+       size == _pushed_constants_size &&
+       memcmp(_pushed_constants.data(), data, size) == 0)
+    {
+        ++_stats.push_constants_elided;
+        return;
+    }
+
+    _pushed_constants_layout = vk_layout;
+    _pushed_constants_stages = shader_stage_flags;
+    _pushed_constants_offset = offset;
+    _pushed_constants_size   = static_cast<uint32_t>(size);
+    memcpy(_pushed_constants.data(), data, size);
+
     vkCmdPushConstants(_vk_handle, vk_layout, shader_stage_flags, offset, size, data);
 }
 
 void VulkanCommandBuffer::transition_image(GPUTexture& texture, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout new_layout)
 {
-    transition_image(texture, texture.layout(), texture.mips(), texture.layers(), src_stages, dst_stages, new_layout);
-    texture.layout(new_layout);
+    VulkanBarrierBatch barriers;
+    transition_image(barriers, texture, src_stages, dst_stages, new_layout);
+    barriers.flush(*this);
+}
+
+void VulkanCommandBuffer::transition_image(VulkanBarrierBatch& barriers, GPUTexture& texture, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout new_layout)
+{
+    const VkImageLayout vk_layout = vulkan_helpers::convert_image_layout(new_layout);
+
+    VulkanImageTransition transition =
+    {
+        .layout     = vk_layout,
+        .stages     = vulkan_helpers::convert_pipeline_stages(dst_stages),
+        .accesses   = vulkan_helpers::find_layout_accesses(vk_layout),
+        .src_stages = vulkan_helpers::convert_pipeline_stages(src_stages)
+    };
+
+    barriers.transition(static_cast<VulkanTexture&>(texture), transition);
 }
 
 void VulkanCommandBuffer::transition_image(
@@ -287,11 +426,15 @@ void VulkanCommandBuffer::reset(void)
     core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "COMMAND BUFFER | " + name() + " | Reset");
     vkResetCommandBuffer(_vk_handle, 0);
     _state = CommandBufferState::INITIAL;
+    _stats = CommandBufferStats{};
+    _reset_bound_state();
 }
 
 void VulkanCommandBuffer::set_viewport(const std::vector<ViewportInfo>& viewports)
 {
-    VkViewport vk_viewports[4];
+    assert(viewports.size() <= constants::max_viewports);
+
+    VkViewport vk_viewports[constants::max_viewports];
     for(size_t i = 0; i < viewports.size(); ++i)
     {
         vk_viewports[i].x        = viewports[i].x;
@@ -302,12 +445,23 @@ void VulkanCommandBuffer::set_viewport(const std::vector<ViewportInfo>& viewport
         vk_viewports[i].maxDepth = viewports[i].max_depth;
     }
 
+    if(viewports.size() == _bound_viewports_count && memcmp(_bound_viewports.data(), vk_viewports, sizeof(VkViewport) * viewports.size()) == 0)
+    {
+        ++_stats.viewports_elided;
+        return;
+    }
+
+    _bound_viewports_count = static_cast<uint32_t>(viewports.size());
+    memcpy(_bound_viewports.data(), vk_viewports, sizeof(VkViewport) * viewports.size());
+
     vkCmdSetViewport(_vk_handle, 0, viewports.size(), &vk_viewports[0]);
 }
 
 void VulkanCommandBuffer::set_scissor(const std::vector<ViewportInfo>& scissors)
 {
-    VkRect2D vk_scissors[4];
+    assert(scissors.size() <= constants::max_scissors);
+
+    VkRect2D vk_scissors[constants::max_scissors];
     for(size_t i = 0; i < scissors.size(); ++i)
     {
         vk_scissors[i].offset.x      = scissors[i].x;
@@ -316,9 +470,43 @@ void VulkanCommandBuffer::set_scissor(const std::vector<ViewportInfo>& scissors)
         vk_scissors[i].extent.height = scissors[i].height;
     }
 
+    if(scissors.size() == _bound_scissors_count && memcmp(_bound_scissors.data(), vk_scissors, sizeof(VkRect2D) * scissors.size()) == 0)
+    {
+        ++_stats.scissors_elided;
+        return;
+    }
+
+    _bound_scissors_count = static_cast<uint32_t>(scissors.size());
+    memcpy(_bound_scissors.data(), vk_scissors, sizeof(VkRect2D) * scissors.size());
+
     vkCmdSetScissor(_vk_handle, 0, scissors.size(), &vk_scissors[0]);
 }
 
+void VulkanCommandBuffer::begin_pass_query(const std::string& name, uint32_t subpasses_count)
+{
+    if(_pass_queries)
+    {
+        _pass_queries->begin_pass(*this, name, subpasses_count);
+    }
+}
+
+void VulkanCommandBuffer::begin_subpass_query(const std::string& name, SubPassContents contents)
+{
+    if(_pass_queries)
+    {
+        assert(_render_pass && "Subpass queries must be inside a render pass");
+        _pass_queries->begin_subpass(*this, name, contents, *_render_pass, _subpass, _framebuffer);
+    }
+}
+
+void VulkanCommandBuffer::end_pass_query(void)
+{
+    if(_pass_queries)
+    {
+        _pass_queries->end_pass(*this);
+    }
+}
+
 bool VulkanCommandBuffer::begin(void)
 {
     if(_state != CommandBufferState::INITIAL)
@@ -339,6 +527,46 @@ bool VulkanCommandBuffer::begin(void)
     vkBeginCommandBuffer(_vk_handle, &info);
 
     _state = CommandBufferState::RECORDING;
+    _stats = CommandBufferStats{};
+    _reset_bound_state();
+
+    return true;
+}
+
+bool VulkanCommandBuffer::begin(const RenderPass& render_pass, uint32_t subpass, const Framebuffer* framebuffer, VkQueryPipelineStatisticFlags pipeline_statistics)
+{
+    if(_state != CommandBufferState::INITIAL)
+    {
+        return false;
+    }
+
+    assert(_level == VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    VkCommandBufferInheritanceInfo inheritance_info =
+    {
+        .sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext                = nullptr,
+        .renderPass           = static_cast<const VulkanRenderPass&>(render_pass).vk_handle(),
+        .subpass              = subpass,
+        .framebuffer          = framebuffer ? static_cast<const VulkanFramebuffer*>(framebuffer)->vk_handle() : VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags           = 0,
+        .pipelineStatistics   = pipeline_statistics
+    };
+
+    VkCommandBufferBeginInfo info =
+    {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext            = nullptr,
+        .flags            = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = &inheritance_info
+    };
+
+    vkBeginCommandBuffer(_vk_handle, &info);
+
+    _state = CommandBufferState::RECORDING;
+    _stats = CommandBufferStats{};
+    _reset_bound_state();
 
     return true;
 }
@@ -350,7 +578,7 @@ void VulkanCommandBuffer::end(void)
     _state = CommandBufferState::EXECUTABLE;
 }
 
-void VulkanCommandBuffer::begin_render_pass(const RenderPass& render_pass, const PerPassData& per_pass_data)
+void VulkanCommandBuffer::begin_render_pass(const RenderPass& render_pass, const PerPassData& per_pass_data, SubPassContents contents)
 {
     VkClearValue vk_clear_values[2];
     vk_clear_values[0].color        = { per_pass_data.colour_clear.r, per_pass_data.colour_clear.g, per_pass_data.colour_clear.b, per_pass_data.colour_clear.a };
@@ -385,29 +613,40 @@ void VulkanCommandBuffer::begin_render_pass(const RenderPass& render_pass, const
     vk_render_pass_begin_info.clearValueCount = 2;
     vk_render_pass_begin_info.pClearValues    = vk_clear_values;
 
-    vkCmdBeginRenderPass(_vk_handle, &vk_render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_vk_handle, &vk_render_pass_begin_info, vulkan_helpers::convert_subpass_contents(contents));
+
+    _render_pass = &render_pass;
+    _framebuffer = per_pass_data.framebuffer;
+    _subpass = 0;
 }
 
 void VulkanCommandBuffer::end_render_pass(void)
 {
     vkCmdEndRenderPass(_vk_handle);
+
+    _render_pass = nullptr;
+    _framebuffer = nullptr;
 }
 
-void VulkanCommandBuffer::next_subpass(void)
+void VulkanCommandBuffer::next_subpass(SubPassContents contents)
 {
-    vkCmdNextSubpass(_vk_handle, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdNextSubpass(_vk_handle, vulkan_helpers::convert_subpass_contents(contents));
+    ++_subpass;
 }
 
 void VulkanCommandBuffer::pipeline_barrier(const PipelineBarrierInfo& info)
 {
-    VkImageMemoryBarrier vk_image_memory_barriers[8];
+    VkImageMemoryBarrier2 vk_image_memory_barriers[8];
+    assert(info.image_memory_barrier_count <= 8);
     for(size_t barrier_idx{ 0 }; barrier_idx < info.image_memory_barrier_count; ++barrier_idx)
     {
         auto& image_info = static_cast<VulkanTexture*>(info.image_memory_barriers[barrier_idx].image)->vk_image_info();
 
-        vk_image_memory_barriers[barrier_idx].sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        vk_image_memory_barriers[barrier_idx].sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
         vk_image_memory_barriers[barrier_idx].pNext               = nullptr;
+        vk_image_memory_barriers[barrier_idx].srcStageMask        = vulkan_helpers::convert_pipeline_stages(info.src_stages);
         vk_image_memory_barriers[barrier_idx].srcAccessMask       = vulkan_helpers::convert_memory_accesses(info.image_memory_barriers[barrier_idx].src_accesses);
+        vk_image_memory_barriers[barrier_idx].dstStageMask        = vulkan_helpers::convert_pipeline_stages(info.dst_stages);
         vk_image_memory_barriers[barrier_idx].dstAccessMask       = vulkan_helpers::convert_memory_accesses(info.image_memory_barriers[barrier_idx].dst_accesses);
         vk_image_memory_barriers[barrier_idx].oldLayout           = vulkan_helpers::convert_image_layout(info.image_memory_barriers[barrier_idx].old_layout);
         vk_image_memory_barriers[barrier_idx].newLayout           = vulkan_helpers::convert_image_layout(info.image_memory_barriers[barrier_idx].new_layout);
@@ -416,7 +655,7 @@ void VulkanCommandBuffer::pipeline_barrier(const PipelineBarrierInfo& info)
         vk_image_memory_barriers[barrier_idx].image               = image_info.image;
         vk_image_memory_barriers[barrier_idx].subresourceRange    =
         {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .aspectMask     = vulkan_helpers::find_image_aspects(vulkan_helpers::convert_format(info.image_memory_barriers[barrier_idx].image->format())),
             .baseMipLevel   = info.image_memory_barriers[barrier_idx].base_mip_level,
             .levelCount     = info.image_memory_barriers[barrier_idx].mip_level_count,
             .baseArrayLayer = info.image_memory_barriers[barrier_idx].base_layer,
@@ -424,13 +663,71 @@ void VulkanCommandBuffer::pipeline_barrier(const PipelineBarrierInfo& info)
         };
     }
 
-    vkCmdPipelineBarrier(
-       _vk_handle,
-       vulkan_helpers::convert_pipeline_stages(info.src_stages),
-       vulkan_helpers::convert_pipeline_stages(info.dst_stages),
-       VK_DEPENDENCY_BY_REGION_BIT,
-       0, nullptr,
-       0, nullptr,
-       info.image_memory_barrier_count, vk_image_memory_barriers
-    );
+    pipeline_barrier({}, { vk_image_memory_barriers, info.image_memory_barrier_count });
+}
+
+void VulkanCommandBuffer::pipeline_barrier(std::span<const VkBufferMemoryBarrier2> buffer_barriers, std::span<const VkImageMemoryBarrier2> image_barriers)
+{
+    if(buffer_barriers.empty() && image_barriers.empty())
+    {
+        return;
+    }
+
+    VkDependencyInfo dependency_info =
+    {
+        .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext                    = nullptr,
+        .dependencyFlags          = 0,
+        .memoryBarrierCount       = 0,
+        .pMemoryBarriers          = nullptr,
+        .bufferMemoryBarrierCount = static_cast<uint32_t>(buffer_barriers.size()),
+        .pBufferMemoryBarriers    = buffer_barriers.data(),
+        .imageMemoryBarrierCount  = static_cast<uint32_t>(image_barriers.size()),
+        .pImageMemoryBarriers     = image_barriers.data()
+    };
+
+    vkCmdPipelineBarrier2(_vk_handle, &dependency_info);
+
+    ++_stats.pipeline_barriers;
+    _stats.image_barriers  += static_cast<uint32_t>(image_barriers.size());
+    _stats.buffer_barriers += static_cast<uint32_t>(buffer_barriers.size());
+}
+
+void VulkanCommandBuffer::reset_query_pool(VkQueryPool query_pool, uint32_t first_query, uint32_t queries_count)
+{
+    vkCmdResetQueryPool(_vk_handle, query_pool, first_query, queries_count);
+}
+
+void VulkanCommandBuffer::write_timestamp(VkPipelineStageFlags2 stage, VkQueryPool query_pool, uint32_t query)
+{
+    vkCmdWriteTimestamp2(_vk_handle, stage, query_pool, query);
+}
+
+void VulkanCommandBuffer::begin_query(VkQueryPool query_pool, uint32_t query)
+{
+    vkCmdBeginQuery(_vk_handle, query_pool, query, 0);
+}
+
+void VulkanCommandBuffer::end_query(VkQueryPool query_pool, uint32_t query)
+{
+    vkCmdEndQuery(_vk_handle, query_pool, query);
+}
+
+void VulkanCommandBuffer::set_pass_queries(VulkanPassQueries* pass_queries)
+{
+    _pass_queries = pass_queries;
+}
+
+void VulkanCommandBuffer::_reset_bound_state(void)
+{
+    _bound_pipeline = VK_NULL_HANDLE;
+    _bound_descriptor_sets_layout = VK_NULL_HANDLE;
+    _bound_descriptor_sets.fill(VK_NULL_HANDLE);
+    _bound_vertex_buffer = VK_NULL_HANDLE;
+    _bound_vertex_buffer_offset = 0;
+    _bound_index_buffer = VK_NULL_HANDLE;
+    _bound_index_buffer_offset = 0;
+    _bound_viewports_count = 0;
+    _bound_scissors_count = 0;
+    _pushed_constants_layout = VK_NULL_HANDLE;
 }
@@ -1,56 +1,80 @@
-//#include "core/command_pool.h"
-//
-//#include "core/device_context.h"
-//#include "core/rend_service.h"
-//
-//#include <new>
-//#include <iostream>
-//
-//using namespace rend;
-//
-//CommandPool::CommandPool(void)
-//{
-//    auto& ctx = *RendService::device_context();
-//
-//    _handle = ctx.create_command_pool();
-//}
-//
-//CommandPool::~CommandPool(void)
-//{
-//    auto& ctx = *RendService::device_context();
-//
-//    for(auto& command_buffer : _command_buffers)
-//    {
-//        ctx.destroy_command_buffer(command_buffer.handle(), _handle);
-//    }
-//
-//    ctx.destroy_command_pool(_handle);
-//}
-//
-//CommandBuffer* CommandPool::create_command_buffer(void)
-//{
-//    auto& ctx = *RendService::device_context();
-//
-//    CommandBufferHandle pool_ref_handle = _command_buffers.allocate();
-//
-//    CommandBuffer* new_buffer = _command_buffers.get(pool_ref_handle);
-//    new_buffer->_handle = ctx.create_command_buffer(_handle);
-//    new_buffer->_pool_reference_handle = pool_ref_handle;
-//
-//    return new_buffer;
-//}
-//
-//void CommandPool::destroy_command_buffer(CommandBuffer* command_buffer)
-//{
-//    auto& ctx = *RendService::device_context();
-//
-//    ctx.destroy_command_buffer(command_buffer->_handle, _handle);
-//
-//    _command_buffers.deallocate(command_buffer->_pool_reference_handle);
-//}
-//
-//void CommandPool::reset(void)
-//{
-//    auto& ctx = *RendService::device_context();
-//    ctx.reset_command_pool(_handle);
-//}
+#include "api/vulkan/vulkan_command_pool.h"
+
+#include "api/vulkan/vulkan_command_buffer.h"
+#include "api/vulkan/vulkan_device_context.h"
+
+using namespace rend;
+
+VulkanCommandPool::VulkanCommandPool(const std::string& name, VulkanDeviceContext& device_context, QueueType queue)
+    :
+        _name(name),
+        _device_context(device_context)
+{
+    // Buffers are never reset individually, the whole pool is recycled at once
+    _vk_handle = _device_context.create_command_pool(queue, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+#if DEBUG
+    _device_context.set_debug_name(_name, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)_vk_handle);
+#endif
+}
+
+VulkanCommandPool::~VulkanCommandPool(void)
+{
+    for(auto* command_buffer : _primary_command_buffers)
+    {
+        _device_context.destroy_command_buffer(command_buffer->vk_handle(), _vk_handle);
+        delete command_buffer;
+    }
+
+    for(auto* command_buffer : _secondary_command_buffers)
+    {
+        _device_context.destroy_command_buffer(command_buffer->vk_handle(), _vk_handle);
+        delete command_buffer;
+    }
+
+    _device_context.destroy_command_pool(_vk_handle);
+}
+
+VkCommandPool VulkanCommandPool::vk_handle(void) const
+{
+    return _vk_handle;
+}
+
+VulkanCommandBuffer* VulkanCommandPool::acquire_command_buffer(VkCommandBufferLevel level)
+{
+    const bool is_primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    auto& command_buffers = is_primary ? _primary_command_buffers : _secondary_command_buffers;
+    auto& used = is_primary ? _primary_command_buffers_used : _secondary_command_buffers_used;
+
+    if(used == command_buffers.size())
+    {
+        std::string name = _name + (is_primary ? " primary " : " secondary ") + std::to_string(used);
+        auto* command_buffer = new VulkanCommandBuffer(name, _device_context.create_command_buffer(_vk_handle, level), level);
+
+#if DEBUG
+        _device_context.set_debug_name(name, VK_OBJECT_TYPE_COMMAND_BUFFER, (uint64_t)command_buffer->vk_handle());
+#endif
+
+        command_buffers.push_back(command_buffer);
+    }
+
+    return command_buffers[used++];
+}
+
+void VulkanCommandPool::reset(void)
+{
+    _device_context.reset_command_pool(_vk_handle);
+
+    for(uint32_t idx = 0; idx < _primary_command_buffers_used; ++idx)
+    {
+        _primary_command_buffers[idx]->_state = CommandBufferState::INITIAL;
+    }
+
+    for(uint32_t idx = 0; idx < _secondary_command_buffers_used; ++idx)
+    {
+        _secondary_command_buffers[idx]->_state = CommandBufferState::INITIAL;
+    }
+
+    _primary_command_buffers_used = 0;
+    _secondary_command_buffers_used = 0;
+}
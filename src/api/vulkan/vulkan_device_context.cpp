@@ -8,6 +8,7 @@
 #include "core/pipeline_layout.h"
 #include "core/rend.h"
 #include "core/render_pass.h"
+#include "core/rend_utils.h"
 #include "core/shader_set.h"
 #include "core/sub_pass.h"
 #include "core/window.h"
@@ -26,6 +27,7 @@
 #include "api/vulkan/vulkan_framebuffer.h"
 #include "api/vulkan/vulkan_helper_funcs.h"
 #include "api/vulkan/vulkan_instance.h"
+#include "api/vulkan/vulkan_memory_allocator.h"
 #include "api/vulkan/vulkan_pipeline.h"
 #include "api/vulkan/vulkan_pipeline_layout.h"
 #include "api/vulkan/vulkan_render_pass.h"
@@ -33,6 +35,7 @@
 #include "api/vulkan/vulkan_shader.h"
 #include "api/vulkan/vulkan_texture.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <GLFW/glfw3.h>
@@ -45,6 +48,22 @@ namespace
 {
     const std::string C_VALIDATION_LOG_FILE_NAME{ "validation.log" };
     const std::string C_VALIDATION_LOG_CHANNEL_NAME{ "validation_channel" };
+
+    // Widens part of an allocation to whole atoms, which stays inside it as non coherent allocations are atom aligned
+    VkMappedMemoryRange mapped_memory_range(const VulkanMemoryAllocation& memory, size_t offset, size_t bytes, VkDeviceSize atom_size)
+    {
+        const VkDeviceSize begin = memory.offset + offset - (memory.offset + offset) % atom_size;
+        const VkDeviceSize end   = std::min<VkDeviceSize>(align_up(memory.offset + offset + bytes, atom_size), memory.offset + memory.bytes);
+
+        return
+        {
+            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+            .pNext  = nullptr,
+            .memory = memory.memory,
+            .offset = begin,
+            .size   = end - begin
+        };
+    }
 }
 
 VulkanDeviceContext::VulkanDeviceContext(VulkanInitInfo& vk_init_info, const Window& window)
@@ -89,17 +108,29 @@ VulkanDeviceContext::VulkanDeviceContext(VulkanInitInfo& vk_init_info, const Win
         throw std::runtime_error(error_string);
     }
 
+    // Optional features are only asked for when the chosen GPU has them
+    _enabled_features = vk_init_info.features;
+    for(DeviceFeature feature : vk_init_info.optional_features)
+    {
+        if(_chosen_gpu->has_features({ feature }))
+        {
+            _enabled_features.push_back(feature);
+        }
+    }
+
     // Create logical device
-    if((_logical_device = _chosen_gpu->create_logical_device(vk_init_info.queues, vk_init_info.features)) == nullptr)
+    if((_logical_device = _chosen_gpu->create_logical_device(vk_init_info.queues, _enabled_features)) == nullptr)
     {
         std::string error_string = "Failed to create logical device";
         throw std::runtime_error(error_string);
     }
 
+    _memory_allocator = new VulkanMemoryAllocator(*_logical_device);
 }
 
 VulkanDeviceContext::~VulkanDeviceContext(void)
 {
+    delete _memory_allocator;
     delete _logical_device;
 
     for(auto physical_device : _physical_devices)
@@ -127,6 +158,11 @@ const VulkanInstance& VulkanDeviceContext::vulkan_instance(void) const
     return *_vulkan_instance;
 }
 
+bool VulkanDeviceContext::has_feature(DeviceFeature feature) const
+{
+    return std::find(_enabled_features.begin(), _enabled_features.end(), feature) != _enabled_features.end();
+}
+
 VulkanBufferInfo VulkanDeviceContext::create_buffer(const BufferInfo& info, VkMemoryPropertyFlags memory_properties)
 {
     uint32_t queue_family_index = _logical_device->get_queue_family(QueueType::GRAPHICS)->get_index();
@@ -141,18 +177,19 @@ VulkanBufferInfo VulkanDeviceContext::create_buffer(const BufferInfo& info, VkMe
     VkBuffer buffer = _logical_device->create_buffer(create_info);
 
     // Allocate memory and bind
-    VkMemoryRequirements memory_reqs = _logical_device->get_buffer_memory_reqs(buffer);
-    VkMemoryAllocateInfo alloc_info = vulkan_helpers::gen_memory_allocate_info();
-    alloc_info.allocationSize = memory_reqs.size;
-    alloc_info.memoryTypeIndex = _logical_device->find_memory_type(memory_reqs.memoryTypeBits, memory_properties);
-    VkDeviceMemory memory = _logical_device->allocate_memory(alloc_info);
-    _logical_device->bind_buffer_memory(buffer, memory);
+    VulkanMemoryAllocation memory = _memory_allocator->allocate_buffer(buffer, memory_properties);
+    if(memory.memory == VK_NULL_HANDLE)
+    {
+        _logical_device->destroy_buffer(buffer);
+        return {};
+    }
+    _logical_device->bind_buffer_memory(buffer, memory.memory, memory.offset);
 
     // Store related data in struct and return
     VulkanBufferInfo buffer_info{};
     buffer_info.buffer = buffer;
     buffer_info.memory = memory;
-    buffer_info.bytes  = memory_reqs.size;
+    buffer_info.bytes  = memory.bytes;
 
     return buffer_info;
 }
@@ -183,19 +220,14 @@ VulkanImageInfo VulkanDeviceContext::create_texture(const TextureInfo& info)
     VkImage image = _logical_device->create_image(create_info);
 
     // Allocate memory and bind
-    VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-    VkMemoryRequirements mem_reqs = _logical_device->get_image_memory_reqs(image);
-    VkMemoryAllocateInfo alloc_info = vulkan_helpers::gen_memory_allocate_info();
-    alloc_info.allocationSize = mem_reqs.size;
-    alloc_info.memoryTypeIndex = _logical_device->find_memory_type(mem_reqs.memoryTypeBits, mem_props);
-
-    auto memory = _logical_device->allocate_memory(alloc_info);
-    if (memory == VK_NULL_HANDLE)
+    const bool render_target = vk_usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+    VulkanMemoryAllocation memory = _memory_allocator->allocate_image(image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, render_target);
+    if (memory.memory == VK_NULL_HANDLE)
     {
         _logical_device->destroy_image(image);
         return {};
     }
-    _logical_device->bind_image_memory(image, memory);
+    _logical_device->bind_image_memory(image, memory.memory, memory.offset);
 
     // Create view and sampler
     VkImageView view = _create_image_view(image, vk_format, VK_IMAGE_VIEW_TYPE_2D, vk_aspect, info.mips, info.layers);
@@ -750,9 +782,9 @@ VkDescriptorSetLayout VulkanDeviceContext::create_descriptor_set_layout(const De
     return vk_descriptor_set_layout;
 }
 
-VkCommandBuffer VulkanDeviceContext::create_command_buffer(VkCommandPool command_pool)
+VkCommandBuffer VulkanDeviceContext::create_command_buffer(VkCommandPool command_pool, VkCommandBufferLevel level)
 {
-    auto vk_command_buffers = _logical_device->allocate_command_buffers(1, VK_COMMAND_BUFFER_LEVEL_PRIMARY, command_pool);
+    auto vk_command_buffers = _logical_device->allocate_command_buffers(1, level, command_pool);
     return vk_command_buffers[0];
 }
 
@@ -793,7 +825,7 @@ VulkanImageInfo VulkanDeviceContext::register_swapchain_image(VkImage swapchain_
 void VulkanDeviceContext::destroy_buffer(const VulkanBufferInfo& buffer_info)
 {
     _logical_device->destroy_buffer(buffer_info.buffer);
-    _logical_device->free_memory(buffer_info.memory);
+    _memory_allocator->free(buffer_info.memory);
 }
 
 void VulkanDeviceContext::destroy_texture(const VulkanImageInfo& image_info)
@@ -811,7 +843,7 @@ void VulkanDeviceContext::destroy_texture(const VulkanImageInfo& image_info)
 
     _logical_device->destroy_image_view(image_info.view);
     _logical_device->destroy_image(image_info.image);
-    _logical_device->free_memory(image_info.memory);
+    _memory_allocator->free(image_info.memory);
 }
 
 void VulkanDeviceContext::destroy_shader(VkShaderModule shader)
@@ -839,6 +871,11 @@ void VulkanDeviceContext::destroy_pipeline(VkPipeline pipeline)
     _logical_device->destroy_pipeline(pipeline);
 }
 
+void VulkanDeviceContext::destroy_query_pool(VkQueryPool query_pool)
+{
+    _logical_device->destroy_query_pool(query_pool);
+}
+
 void VulkanDeviceContext::unregister_swapchain_image(const VulkanImageInfo& image_info)
 {
     _logical_device->destroy_image_view(image_info.view);
@@ -854,21 +891,36 @@ VkFence VulkanDeviceContext::create_fence(const VkFenceCreateInfo& info)
     return _logical_device->create_fence(info);
 }
 
+VkQueryPool VulkanDeviceContext::create_query_pool(const VkQueryPoolCreateInfo& info)
+{
+    return _logical_device->create_query_pool(info);
+}
+
 VkSemaphore VulkanDeviceContext::create_semaphore(const VkSemaphoreCreateInfo& info)
 {
     return _logical_device->create_semaphore(info);
 }
 
 VkCommandPool VulkanDeviceContext::create_command_pool(void)
+{
+    return create_command_pool(QueueType::GRAPHICS, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+}
+
+VkCommandPool VulkanDeviceContext::create_command_pool(QueueType queue, VkCommandPoolCreateFlags flags)
 {
     VkCommandPoolCreateInfo create_info = vulkan_helpers::gen_command_pool_create_info();
-    create_info.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    create_info.queueFamilyIndex        = _logical_device->get_queue_family(QueueType::GRAPHICS)->get_index();
+    create_info.flags                   = flags;
+    create_info.queueFamilyIndex        = _logical_device->get_queue_family(queue)->get_index();
 
     VkCommandPool vk_command_pool = _logical_device->create_command_pool(create_info);
     return vk_command_pool;
 }
 
+void VulkanDeviceContext::reset_command_pool(VkCommandPool command_pool)
+{
+    _logical_device->reset_command_pool(command_pool);
+}
+
 void VulkanDeviceContext::destroy_event(VkEvent event)
 {
     _logical_device->destroy_event(event);
@@ -933,15 +985,21 @@ void VulkanDeviceContext::write_descriptor_bindings(VkDescriptorSet vk_set, cons
             }
 
             case DescriptorType::UNIFORM_BUFFER:
+            case DescriptorType::STORAGE_BUFFER:
+            case DescriptorType::UNIFORM_BUFFER_DYNAMIC:
+            case DescriptorType::STORAGE_BUFFER_DYNAMIC:
             {
                 //VulkanBufferInfo& buffer_info = *_vk_buffer_infos.get(binding.handle);
 
                 auto& buffer_info = static_cast<VulkanBuffer*>(binding.resource)->vk_buffer_info();
 
+                // A dynamic offset moves the range, which must still fit in the buffer
+                assert((binding.range > 0 || (binding.type != DescriptorType::UNIFORM_BUFFER_DYNAMIC && binding.type != DescriptorType::STORAGE_BUFFER_DYNAMIC)) && "Dynamic buffer bindings need a range");
+
                 VkDescriptorBufferInfo vk_buffer_info{};
                 vk_buffer_info.buffer  = buffer_info.buffer;
                 vk_buffer_info.offset = 0;
-                vk_buffer_info.range   = buffer_info.bytes;
+                vk_buffer_info.range   = binding.range > 0 ? binding.range : buffer_info.bytes;
 
                 vk_desc_buffer_infos[desc_buffer_idx] = vk_buffer_info;
 
@@ -958,38 +1016,53 @@ void VulkanDeviceContext::write_descriptor_bindings(VkDescriptorSet vk_set, cons
     _logical_device->update_descriptor_sets( vk_write_sets );
 }
 
-void* VulkanDeviceContext::map_buffer_memory(GPUBuffer& buffer, size_t bytes)
+void VulkanDeviceContext::flush_buffer_memory(const GPUBuffer& buffer, size_t offset, size_t bytes)
 {
-    void* mapped = nullptr;
-    auto& buffer_info = static_cast<VulkanBuffer&>(buffer).vk_buffer_info();
-    _logical_device->map_memory(buffer_info.memory, bytes, 0, &mapped);
-    return mapped;
+    const auto& buffer_info = static_cast<const VulkanBuffer&>(buffer).vk_buffer_info();
+    assert(buffer_info.memory.mapped != nullptr && "Flushing a buffer that is not host visible");
+    assert(offset + bytes <= buffer_info.bytes);
+
+    // Host writes to coherent memory reach the device on their own
+    if(buffer_info.memory.host_coherent || bytes == 0)
+    {
+        return;
+    }
+
+    _logical_device->flush_memory(mapped_memory_range(buffer_info.memory, offset, bytes, _chosen_gpu->get_properties().limits.nonCoherentAtomSize));
 }
 
-void VulkanDeviceContext::unmap_buffer_memory(GPUBuffer& buffer)
+void VulkanDeviceContext::invalidate_buffer_memory(const GPUBuffer& buffer, size_t offset, size_t bytes)
 {
-    auto& buffer_info = static_cast<VulkanBuffer&>(buffer).vk_buffer_info();
-    _logical_device->unmap_memory(buffer_info.memory);
+    const auto& buffer_info = static_cast<const VulkanBuffer&>(buffer).vk_buffer_info();
+    assert(buffer_info.memory.mapped != nullptr && "Invalidating a buffer that is not host visible");
+    assert(offset + bytes <= buffer_info.bytes);
+
+    // Device writes to coherent memory reach the host on their own
+    if(buffer_info.memory.host_coherent || bytes == 0)
+    {
+        return;
+    }
+
+    _logical_device->invalidate_memory(mapped_memory_range(buffer_info.memory, offset, bytes, _chosen_gpu->get_properties().limits.nonCoherentAtomSize));
 }
 
 void* VulkanDeviceContext::map_image_memory(GPUTexture& texture, size_t bytes)
 {
-    void* mapped = nullptr;
     auto& image_info = static_cast<VulkanTexture&>(texture).vk_image_info();
-    _logical_device->map_memory(image_info.memory, bytes, 0, &mapped);
-    return mapped;
+    assert(image_info.memory.mapped != nullptr && "Mapping an image that is not host visible");
+    assert(bytes <= image_info.memory.bytes);
+    return image_info.memory.mapped;
 }
 
 void VulkanDeviceContext::unmap_image_memory(GPUTexture& texture)
 {
-    auto& image_info = static_cast<VulkanTexture&>(texture).vk_image_info();
-    _logical_device->unmap_memory(image_info.memory);
+    (void)texture;
 }
 
-void VulkanDeviceContext::queue_submit(const VulkanCommandBuffer& cmd, QueueType queue, const std::vector<Semaphore*>& wait_for_semaphores, const std::vector<Semaphore*>& signal_semaphores, const Fence* signal_fence)
+void VulkanDeviceContext::queue_submit(const VulkanCommandBuffer& cmd, QueueType queue, const std::vector<Semaphore*>& wait_for_semaphores, const std::vector<Semaphore*>& signal_semaphores, const std::vector<TimelinePoint>& timeline_waits, const std::vector<TimelinePoint>& timeline_signals, const Fence* signal_fence)
 {
     VkCommandBuffer vk_command_buffer = cmd.vk_handle();
-    _logical_device->queue_submit(&vk_command_buffer, 1, queue, wait_for_semaphores, signal_semaphores, signal_fence);
+    _logical_device->queue_submit(&vk_command_buffer, 1, queue, wait_for_semaphores, signal_semaphores, timeline_waits, timeline_signals, signal_fence);
 }
 
 void VulkanDeviceContext::set_debug_name(const std::string& name, VkObjectType type, uint64_t handle)
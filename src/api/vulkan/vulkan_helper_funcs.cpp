@@ -83,6 +83,27 @@ VkImageAspectFlags vulkan_helpers::find_image_aspects(VkFormat format)
     return flags;
 }
 
+VkAccessFlags2 vulkan_helpers::find_layout_accesses(VkImageLayout layout)
+{
+    switch(layout)
+    {
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            return VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            return VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            return VK_ACCESS_2_TRANSFER_READ_BIT;
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            return VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        case VK_IMAGE_LAYOUT_GENERAL:
+            return VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        default:
+            return VK_ACCESS_2_NONE;
+    }
+}
+
 VkAttachmentDescription vulkan_helpers::convert_attachment_description(const AttachmentInfo& info)
 {
     return
@@ -241,6 +262,17 @@ VkPipelineBindPoint vulkan_helpers::convert_pipeline_bind_point(PipelineBindPoin
     return VK_PIPELINE_BIND_POINT_GRAPHICS;
 }
 
+VkSubpassContents vulkan_helpers::convert_subpass_contents(SubPassContents contents)
+{
+    switch(contents)
+    {
+        case SubPassContents::INLINE: return VK_SUBPASS_CONTENTS_INLINE;
+        case SubPassContents::SECONDARY_COMMAND_BUFFERS: return VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+    }
+
+    return VK_SUBPASS_CONTENTS_INLINE;
+}
+
 VkPipelineStageFlagBits vulkan_helpers::convert_pipeline_stage(PipelineStage stage)
 {
     switch(stage)
@@ -311,6 +343,18 @@ VkPolygonMode vulkan_helpers::convert_polygon_mode(PolygonMode mode)
     return VK_POLYGON_MODE_MAX_ENUM;
 }
 
+VkPresentModeKHR vulkan_helpers::convert_present_mode(PresentMode mode)
+{
+    switch(mode)
+    {
+        case PresentMode::FIFO:      return VK_PRESENT_MODE_FIFO_KHR;
+        case PresentMode::MAILBOX:   return VK_PRESENT_MODE_MAILBOX_KHR;
+        case PresentMode::IMMEDIATE: return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    }
+
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
 VkFrontFace vulkan_helpers::convert_front_face(FrontFace face)
 {
     switch(face)
@@ -560,6 +604,8 @@ VkBufferUsageFlags vulkan_helpers::convert_buffer_usage_flags(BufferUsage usage)
                 case BufferUsage::VERTEX_BUFFER: ret |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT; break;
                 case BufferUsage::INDEX_BUFFER: ret |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT; break;
                 case BufferUsage::UNIFORM_BUFFER: ret |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT; break;
+                case BufferUsage::STORAGE_BUFFER: ret |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; break;
+                case BufferUsage::INDIRECT_BUFFER: ret |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT; break;
                 case BufferUsage::NONE:
                 default:
                     break;
@@ -863,6 +909,32 @@ VkPhysicalDeviceVulkan12Features vulkan_helpers::gen_vk_1_2_features(void)
     return vk_1_2_features;
 }
 
+VkPhysicalDeviceVulkan13Features vulkan_helpers::gen_vk_1_3_features(void)
+{
+    VkPhysicalDeviceVulkan13Features vk_1_3_features =
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .pNext = nullptr,
+        .robustImageAccess = VK_FALSE,
+        .inlineUniformBlock = VK_FALSE,
+        .descriptorBindingInlineUniformBlockUpdateAfterBind = VK_FALSE,
+        .pipelineCreationCacheControl = VK_FALSE,
+        .privateData = VK_FALSE,
+        .shaderDemoteToHelperInvocation = VK_FALSE,
+        .shaderTerminateInvocation = VK_FALSE,
+        .subgroupSizeControl = VK_FALSE,
+        .computeFullSubgroups = VK_FALSE,
+        .synchronization2 = VK_FALSE,
+        .textureCompressionASTC_HDR = VK_FALSE,
+        .shaderZeroInitializeWorkgroupMemory = VK_FALSE,
+        .dynamicRendering = VK_FALSE,
+        .shaderIntegerDotProduct = VK_FALSE,
+        .maintenance4 = VK_FALSE
+    };
+
+    return vk_1_3_features;
+}
+
 VkPipelineLayoutCreateInfo vulkan_helpers::gen_pipeline_layout_create_info(void)
 {
     VkPipelineLayoutCreateInfo info = {};
@@ -0,0 +1,290 @@
+#include "api/vulkan/vulkan_memory_allocator.h"
+
+#include "api/vulkan/logical_device.h"
+#include "api/vulkan/physical_device.h"
+#include "api/vulkan/vulkan_helper_funcs.h"
+#include "core/logging/log_defs.h"
+#include "core/logging/log_manager.h"
+#include "core/rend_utils.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string>
+
+using namespace rend;
+
+namespace
+{
+    // Oversized blocks are rounded to this so a run of large resources do not each get an odd sized block
+    const VkDeviceSize C_BLOCK_BYTES_GRANULARITY{ 1024ull * 1024 };
+}
+
+VulkanMemoryAllocator::Block::Block(VkDeviceMemory memory, void* mapped, uint32_t pool, VkDeviceSize bytes)
+    :
+        memory(memory),
+        mapped(mapped),
+        pool(pool),
+        allocator(bytes)
+{
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(LogicalDevice& logical_device)
+    :
+        _logical_device(logical_device)
+{
+    const PhysicalDevice& physical_device = _logical_device.get_physical_device();
+    _memory_properties = physical_device.get_memory_properties();
+    _buffer_image_granularity = physical_device.get_properties().limits.bufferImageGranularity;
+    _non_coherent_atom_size = physical_device.get_properties().limits.nonCoherentAtomSize;
+    _pools.resize(_memory_properties.memoryTypeCount * static_cast<uint32_t>(Tiling::COUNT));
+
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "MEMORY | Created memory allocator with params: { memory types: " + std::to_string(_memory_properties.memoryTypeCount) + ", buffer image granularity: " + std::to_string(_buffer_image_granularity) + ", max allocations: " + std::to_string(physical_device.get_properties().limits.maxMemoryAllocationCount) + " }");
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator(void)
+{
+    for(uint32_t block = 0; block < _blocks.size(); ++block)
+    {
+        if(_blocks[block] != nullptr)
+        {
+            _destroy_block(block);
+        }
+    }
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::allocate_buffer(VkBuffer buffer, VkMemoryPropertyFlags memory_properties)
+{
+    return _allocate(_logical_device.get_buffer_memory_reqs(buffer), memory_properties, Tiling::LINEAR);
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::allocate_image(VkImage image, VkMemoryPropertyFlags memory_properties, bool render_target)
+{
+    const VkMemoryRequirements memory_reqs = _logical_device.get_image_memory_reqs(image);
+
+    if(render_target && memory_reqs.size >= _DEDICATED_RENDER_TARGET_BYTES)
+    {
+        return _allocate_dedicated(memory_reqs, memory_properties, image);
+    }
+
+    return _allocate(memory_reqs, memory_properties, Tiling::OPTIMAL);
+}
+
+void VulkanMemoryAllocator::free(const VulkanMemoryAllocation& allocation)
+{
+    if(allocation.memory == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if(allocation.block == VulkanMemoryAllocation::C_DEDICATED)
+    {
+        _logical_device.free_memory(allocation.memory);
+        --_dedicated_count;
+        return;
+    }
+
+    Block* block = _blocks[allocation.block];
+    assert(block != nullptr && block->memory == allocation.memory && "Freeing memory from a block it was not allocated from");
+
+    block->allocator.free({ allocation.offset, allocation.bytes, allocation.node });
+
+    // One empty block is kept per pool so a resource freed and created each frame does not churn device memory
+    if(block->allocator.allocations_count() == 0 && _pools[block->pool].size() > 1)
+    {
+        _destroy_block(allocation.block);
+    }
+}
+
+uint32_t VulkanMemoryAllocator::_find_memory_type(uint32_t memory_type_bits, VkMemoryPropertyFlags memory_properties) const
+{
+    for(uint32_t idx = 0; idx < _memory_properties.memoryTypeCount; ++idx)
+    {
+        const bool allowed = memory_type_bits & (1u << idx);
+        const bool has_properties = (_memory_properties.memoryTypes[idx].propertyFlags & memory_properties) == memory_properties;
+
+        if(allowed && has_properties)
+        {
+            return idx;
+        }
+    }
+
+    return VK_MAX_MEMORY_TYPES;
+}
+
+bool VulkanMemoryAllocator::_is_host_coherent(uint32_t memory_type) const
+{
+    return _memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::_allocate(const VkMemoryRequirements& resource_reqs, VkMemoryPropertyFlags memory_properties, Tiling tiling)
+{
+    const uint32_t memory_type = _find_memory_type(resource_reqs.memoryTypeBits, memory_properties);
+    if(memory_type == VK_MAX_MEMORY_TYPES)
+    {
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "MEMORY | No memory type with properties: " + std::to_string(memory_properties));
+        return {};
+    }
+
+    // Flushes and invalidates work in whole atoms
+    VkMemoryRequirements memory_reqs = resource_reqs;
+    const bool host_visible = _memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    if(host_visible && !_is_host_coherent(memory_type))
+    {
+        memory_reqs.alignment = std::max(memory_reqs.alignment, _non_coherent_atom_size);
+        memory_reqs.size      = align_up(memory_reqs.size, _non_coherent_atom_size);
+    }
+
+    // Without a granularity to respect, buffers and images can share blocks
+    if(_buffer_image_granularity <= 1)
+    {
+        tiling = Tiling::LINEAR;
+    }
+
+    const uint32_t pool = memory_type * static_cast<uint32_t>(Tiling::COUNT) + static_cast<uint32_t>(tiling);
+
+    auto make_allocation = [this, memory_type, &memory_reqs](uint32_t block, const TLSFAllocation& range)
+    {
+        VulkanMemoryAllocation allocation{};
+        allocation.memory        = _blocks[block]->memory;
+        allocation.offset        = range.offset;
+        allocation.bytes         = memory_reqs.size;
+        allocation.mapped        = _blocks[block]->mapped ? static_cast<char*>(_blocks[block]->mapped) + range.offset : nullptr;
+        allocation.host_coherent = _is_host_coherent(memory_type);
+        allocation.memory_type   = memory_type;
+        allocation.block         = block;
+        allocation.node          = range.node;
+        return allocation;
+    };
+
+    for(uint32_t block : _pools[pool])
+    {
+        const TLSFAllocation range = _blocks[block]->allocator.allocate(memory_reqs.size, memory_reqs.alignment);
+        if(range.node != TLSFAllocator::C_NO_NODE)
+        {
+            return make_allocation(block, range);
+        }
+    }
+
+    const VkDeviceSize heap_bytes = _memory_properties.memoryHeaps[_memory_properties.memoryTypes[memory_type].heapIndex].size;
+    VkDeviceSize block_bytes = heap_bytes <= _SMALL_HEAP_BYTES ? heap_bytes / 8 : _BLOCK_BYTES;
+    block_bytes = std::max(block_bytes, align_up(memory_reqs.size + memory_reqs.alignment, C_BLOCK_BYTES_GRANULARITY));
+
+    const uint32_t block = _create_block(pool, block_bytes);
+    if(block == _NO_BLOCK)
+    {
+        return {};
+    }
+
+    const TLSFAllocation range = _blocks[block]->allocator.allocate(memory_reqs.size, memory_reqs.alignment);
+    assert(range.node != TLSFAllocator::C_NO_NODE && "New memory block too small for the allocation it was made for");
+
+    return make_allocation(block, range);
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::_allocate_dedicated(const VkMemoryRequirements& memory_reqs, VkMemoryPropertyFlags memory_properties, VkImage image)
+{
+    const uint32_t memory_type = _find_memory_type(memory_reqs.memoryTypeBits, memory_properties);
+    if(memory_type == VK_MAX_MEMORY_TYPES)
+    {
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "MEMORY | No memory type with properties: " + std::to_string(memory_properties));
+        return {};
+    }
+
+    VulkanMemoryAllocation allocation{};
+    allocation.memory = _allocate_memory(memory_reqs.size, memory_type, image, &allocation.mapped);
+    if(allocation.memory == VK_NULL_HANDLE)
+    {
+        return {};
+    }
+
+    allocation.bytes         = memory_reqs.size;
+    allocation.host_coherent = _is_host_coherent(memory_type);
+    allocation.memory_type   = memory_type;
+    ++_dedicated_count;
+
+    return allocation;
+}
+
+VkDeviceMemory VulkanMemoryAllocator::_allocate_memory(VkDeviceSize bytes, uint32_t memory_type, VkImage dedicated_image, void** mapped)
+{
+    VkMemoryDedicatedAllocateInfo dedicated_info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .pNext  = nullptr,
+        .image  = dedicated_image,
+        .buffer = VK_NULL_HANDLE
+    };
+
+    VkMemoryAllocateInfo alloc_info = vulkan_helpers::gen_memory_allocate_info();
+    alloc_info.pNext           = dedicated_image != VK_NULL_HANDLE ? &dedicated_info : nullptr;
+    alloc_info.allocationSize  = bytes;
+    alloc_info.memoryTypeIndex = memory_type;
+
+    VkDeviceMemory memory = _logical_device.allocate_memory(alloc_info);
+    if(memory == VK_NULL_HANDLE)
+    {
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "MEMORY | Failed to allocate " + std::to_string(bytes) + " bytes of memory type " + std::to_string(memory_type));
+        return VK_NULL_HANDLE;
+    }
+
+    // Memory shared by many resources cannot be mapped by each of them, so it is mapped once here
+    *mapped = nullptr;
+    if(_memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if(!_logical_device.map_memory(memory, VK_WHOLE_SIZE, 0, mapped))
+        {
+            _logical_device.free_memory(memory);
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    return memory;
+}
+
+uint32_t VulkanMemoryAllocator::_create_block(uint32_t pool, VkDeviceSize bytes)
+{
+    const uint32_t memory_type = pool / static_cast<uint32_t>(Tiling::COUNT);
+
+    void* mapped = nullptr;
+    VkDeviceMemory memory = _allocate_memory(bytes, memory_type, VK_NULL_HANDLE, &mapped);
+    if(memory == VK_NULL_HANDLE)
+    {
+        return _NO_BLOCK;
+    }
+
+    uint32_t block{ _NO_BLOCK };
+    if(_unused_blocks.empty())
+    {
+        block = static_cast<uint32_t>(_blocks.size());
+        _blocks.push_back(nullptr);
+    }
+    else
+    {
+        block = _unused_blocks.back();
+        _unused_blocks.pop_back();
+    }
+
+    _blocks[block] = new Block(memory, mapped, pool, bytes);
+    _pools[pool].push_back(block);
+
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "MEMORY | Created block " + std::to_string(block) + " with params: { bytes: " + std::to_string(bytes) + ", memory type: " + std::to_string(memory_type) + ", tiling: " + std::to_string(pool % static_cast<uint32_t>(Tiling::COUNT)) + " }");
+
+    return block;
+}
+
+void VulkanMemoryAllocator::_destroy_block(uint32_t block)
+{
+    Block* memory_block = _blocks[block];
+
+    auto& pool_blocks = _pools[memory_block->pool];
+    pool_blocks.erase(std::find(pool_blocks.begin(), pool_blocks.end(), block));
+
+    // Freeing implicitly unmaps
+    _logical_device.free_memory(memory_block->memory);
+
+    delete memory_block;
+    _blocks[block] = nullptr;
+    _unused_blocks.push_back(block);
+
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "MEMORY | Destroyed block " + std::to_string(block));
+}
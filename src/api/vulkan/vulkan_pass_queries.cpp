@@ -0,0 +1,264 @@
+#include "api/vulkan/vulkan_pass_queries.h"
+
+#include "api/vulkan/logical_device.h"
+#include "api/vulkan/physical_device.h"
+#include "api/vulkan/vulkan_command_buffer.h"
+#include "api/vulkan/vulkan_command_pool.h"
+#include "api/vulkan/vulkan_device_context.h"
+#include "core/logging/log_defs.h"
+#include "core/logging/log_manager.h"
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+
+using namespace rend;
+
+namespace
+{
+    // Ordered as the results are written, lowest bit first
+    const VkQueryPipelineStatisticFlags C_PIPELINE_STATISTICS =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+    // Waiting on all prior commands keeps each pass's interval from overlapping the one before
+    const VkPipelineStageFlags2 C_TIMESTAMP_STAGE = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+}
+
+VulkanPassQueries::VulkanPassQueries(const std::string& name, VulkanDeviceContext& device_context, bool pipeline_statistics)
+    :
+        _name(name),
+        _device_context(device_context)
+{
+    assert(is_supported(_device_context));
+
+    const uint32_t valid_bits = _device_context.get_device()->get_queue_family(QueueType::GRAPHICS)->get_properties().timestampValidBits;
+    _timestamp_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+    _timestamp_period_ns = _device_context.gpu()->get_properties().limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo create_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext              = nullptr,
+        .flags              = 0,
+        .queryType          = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount         = _TIMESTAMPS_MAX,
+        .pipelineStatistics = 0
+    };
+
+    _timestamp_pool = _device_context.create_query_pool(create_info);
+
+#if DEBUG
+    _device_context.set_debug_name(_name + " timestamps", VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)_timestamp_pool);
+#endif
+
+    if(pipeline_statistics)
+    {
+        create_info.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        create_info.queryCount         = _PASSES_MAX;
+        create_info.pipelineStatistics = C_PIPELINE_STATISTICS;
+
+        _statistics_pool = _device_context.create_query_pool(create_info);
+        _pipeline_statistics = C_PIPELINE_STATISTICS;
+
+#if DEBUG
+        _device_context.set_debug_name(_name + " pipeline statistics", VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)_statistics_pool);
+#endif
+    }
+
+    _command_pool = new VulkanCommandPool(_name + " command pool", _device_context, QueueType::GRAPHICS);
+    _passes.reserve(_PASSES_MAX);
+
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "PASS QUERIES | Created pass queries (" + _name + ") with params: { timestamp period ns: " + std::to_string(_timestamp_period_ns) + ", valid bits: " + std::to_string(valid_bits) + ", pipeline statistics: " + std::to_string(pipeline_statistics) + " }");
+}
+
+VulkanPassQueries::~VulkanPassQueries(void)
+{
+    delete _command_pool;
+
+    if(_statistics_pool != VK_NULL_HANDLE)
+    {
+        _device_context.destroy_query_pool(_statistics_pool);
+    }
+
+    _device_context.destroy_query_pool(_timestamp_pool);
+}
+
+bool VulkanPassQueries::is_supported(const VulkanDeviceContext& device_context)
+{
+    return device_context.get_device()->get_queue_family(QueueType::GRAPHICS)->get_properties().timestampValidBits > 0;
+}
+
+VkQueryPipelineStatisticFlags VulkanPassQueries::pipeline_statistics(void) const
+{
+    return _pipeline_statistics;
+}
+
+void VulkanPassQueries::read_results(std::vector<GPUPassTiming>& timings)
+{
+    assert(_active_pass == _NO_PASS && "Reading results while a pass is being recorded");
+
+    timings.clear();
+
+    // Each query is followed by its availability, a pass whose queries are not all available is skipped
+    const VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+    std::array<uint64_t, _TIMESTAMPS_MAX * 2> timestamps{};
+    std::array<uint64_t, _STATISTICS_COUNT + 1> statistics{};
+
+    for(uint32_t pass_idx = 0; pass_idx < _passes.size(); ++pass_idx)
+    {
+        const PassQuery& pass = _passes[pass_idx];
+        const uint32_t timestamps_count = pass.subpasses_count + 1;
+
+        _device_context.get_device()->get_query_pool_results(
+            _timestamp_pool, pass.first_timestamp, timestamps_count,
+            timestamps_count * 2 * sizeof(uint64_t), timestamps.data(), 2 * sizeof(uint64_t), flags
+        );
+
+        bool available = true;
+        for(uint32_t idx = 0; idx < timestamps_count; ++idx)
+        {
+            available &= timestamps[idx * 2 + 1] != 0;
+        }
+
+        if(_statistics_pool != VK_NULL_HANDLE)
+        {
+            _device_context.get_device()->get_query_pool_results(
+                _statistics_pool, pass_idx, 1, sizeof(statistics), statistics.data(), sizeof(statistics), flags
+            );
+
+            available &= statistics[_STATISTICS_COUNT] != 0;
+        }
+
+        if(!available)
+        {
+            continue;
+        }
+
+        auto ticks_to_ms = [this](uint64_t begin, uint64_t end)
+        {
+            return static_cast<double>((end - begin) & _timestamp_mask) * _timestamp_period_ns / 1000000.0;
+        };
+
+        GPUPassTiming& timing = timings.emplace_back();
+        timing.name   = pass.name;
+        timing.gpu_ms = ticks_to_ms(timestamps[0], timestamps[pass.subpasses_count * 2]);
+
+        if(_statistics_pool != VK_NULL_HANDLE)
+        {
+            timing.input_assembly_vertices     = statistics[0];
+            timing.input_assembly_primitives   = statistics[1];
+            timing.vertex_shader_invocations   = statistics[2];
+            timing.clipping_primitives         = statistics[3];
+            timing.fragment_shader_invocations = statistics[4];
+        }
+
+        for(uint32_t subpass_idx = 0; subpass_idx < pass.subpass_names.size(); ++subpass_idx)
+        {
+            timing.subpasses.push_back({ pass.subpass_names[subpass_idx], ticks_to_ms(timestamps[subpass_idx * 2], timestamps[(subpass_idx + 1) * 2]) });
+        }
+    }
+}
+
+void VulkanPassQueries::reset(VulkanCommandBuffer& command_buffer)
+{
+    // The GPU is done with the last use of this frame, so are its timestamp secondaries
+    _command_pool->reset();
+    _passes.clear();
+    _timestamps_used = 0;
+    _active_pass = _NO_PASS;
+
+    command_buffer.reset_query_pool(_timestamp_pool, 0, _TIMESTAMPS_MAX);
+
+    if(_statistics_pool != VK_NULL_HANDLE)
+    {
+        command_buffer.reset_query_pool(_statistics_pool, 0, _PASSES_MAX);
+    }
+}
+
+void VulkanPassQueries::begin_pass(VulkanCommandBuffer& command_buffer, const std::string& name, uint32_t subpasses_count)
+{
+    assert(_active_pass == _NO_PASS && "Draw passes do not nest");
+
+    if(_passes.size() == _PASSES_MAX || _timestamps_used + subpasses_count + 1 > _TIMESTAMPS_MAX)
+    {
+        return;
+    }
+
+    _active_pass = static_cast<uint32_t>(_passes.size());
+
+    PassQuery& pass = _passes.emplace_back();
+    pass.name = name;
+    pass.first_timestamp = _timestamps_used;
+    pass.subpasses_count = subpasses_count;
+    _timestamps_used += subpasses_count + 1;
+
+    command_buffer.write_timestamp(C_TIMESTAMP_STAGE, _timestamp_pool, pass.first_timestamp);
+
+    if(_statistics_pool != VK_NULL_HANDLE)
+    {
+        command_buffer.begin_query(_statistics_pool, _active_pass);
+    }
+}
+
+void VulkanPassQueries::begin_subpass(VulkanCommandBuffer& command_buffer, const std::string& name, SubPassContents contents, const RenderPass& render_pass, uint32_t subpass, const Framebuffer* framebuffer)
+{
+    if(_active_pass == _NO_PASS)
+    {
+        return;
+    }
+
+    PassQuery& pass = _passes[_active_pass];
+    const uint32_t subpass_idx = static_cast<uint32_t>(pass.subpass_names.size());
+    assert(subpass_idx < pass.subpasses_count);
+
+    pass.subpass_names.push_back(name);
+
+    // The first subpass starts with the pass
+    if(subpass_idx == 0)
+    {
+        return;
+    }
+
+    const uint32_t query = pass.first_timestamp + subpass_idx;
+
+    if(contents == SubPassContents::INLINE)
+    {
+        command_buffer.write_timestamp(C_TIMESTAMP_STAGE, _timestamp_pool, query);
+        return;
+    }
+
+    // A subpass begun for secondaries may only execute them
+    auto* timestamp_cmd = _command_pool->acquire_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    timestamp_cmd->begin(render_pass, subpass, framebuffer, _pipeline_statistics);
+    timestamp_cmd->write_timestamp(C_TIMESTAMP_STAGE, _timestamp_pool, query);
+    timestamp_cmd->end();
+
+    command_buffer.execute_commands({ timestamp_cmd });
+}
+
+void VulkanPassQueries::end_pass(VulkanCommandBuffer& command_buffer)
+{
+    if(_active_pass == _NO_PASS)
+    {
+        return;
+    }
+
+    PassQuery& pass = _passes[_active_pass];
+
+    if(_statistics_pool != VK_NULL_HANDLE)
+    {
+        command_buffer.end_query(_statistics_pool, _active_pass);
+    }
+
+    // Subpasses never begun take no time, their starts are written so the pass still reads back
+    for(uint32_t subpass_idx = std::max<uint32_t>(pass.subpass_names.size(), 1); subpass_idx <= pass.subpasses_count; ++subpass_idx)
+    {
+        command_buffer.write_timestamp(C_TIMESTAMP_STAGE, _timestamp_pool, pass.first_timestamp + subpass_idx);
+    }
+
+    _active_pass = _NO_PASS;
+}
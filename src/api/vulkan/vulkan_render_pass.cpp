@@ -22,10 +22,10 @@ VkRenderPass VulkanRenderPass::vk_handle(void) const
     return _vk_handle;
 }
 
-void VulkanRenderPass::begin(CommandBuffer& command_buffer, const PerPassData& per_pass_data)
+void VulkanRenderPass::begin(CommandBuffer& command_buffer, const PerPassData& per_pass_data, SubPassContents contents)
 {
     auto& vk_cmd = static_cast<VulkanCommandBuffer&>(command_buffer);
-    vk_cmd.begin_render_pass(*this, per_pass_data);
+    vk_cmd.begin_render_pass(*this, per_pass_data, contents);
 }
 
 void VulkanRenderPass::end(CommandBuffer& command_buffer)
@@ -34,8 +34,8 @@ void VulkanRenderPass::end(CommandBuffer& command_buffer)
     vk_cmd.end_render_pass();
 }
 
-void VulkanRenderPass::next_subpass(CommandBuffer& command_buffer)
+void VulkanRenderPass::next_subpass(CommandBuffer& command_buffer, SubPassContents contents)
 {
     auto& vk_cmd = static_cast<VulkanCommandBuffer&>(command_buffer);
-    vk_cmd.next_subpass();
+    vk_cmd.next_subpass(contents);
 }
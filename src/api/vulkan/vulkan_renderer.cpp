@@ -5,8 +5,12 @@
 #include "core/descriptor_pool.h"
 #include "core/device_context.h"
 #include "core/material.h"
+#include "core/frustum_culling.h"
+#include "core/profiler.h"
+#include "core/radix_sort.h"
 #include "core/rend.h"
 #include "core/rend_defs.h"
+#include "core/rend_utils.h"
 #include "core/sub_pass.h"
 #include "core/window.h"
 
@@ -14,20 +18,26 @@
 #include "core/logging/log_manager.h"
 
 #include "api/vulkan/extensions.h"
-#include "api/vulkan/fence.h"
 #include "api/vulkan/layers.h"
 #include "api/vulkan/logical_device.h"
 #include "api/vulkan/swapchain.h"
+#include "api/vulkan/timeline_semaphore.h"
 #include "api/vulkan/vulkan_command_buffer.h"
 #include "api/vulkan/vulkan_device_context.h"
 #include "api/vulkan/vulkan_helper_funcs.h"
 #include "api/vulkan/vulkan_instance.h"
+#include "api/vulkan/vulkan_pass_queries.h"
 #include "api/vulkan/vulkan_semaphore.h"
+#include "api/vulkan/vulkan_staging_ring.h"
+#include "api/vulkan/vulkan_upload_queue.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <cstring>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <fstream>
 
@@ -54,6 +64,40 @@ namespace
 
         std::cerr << "GLFW error code: " << error << std::endl << description << std::endl;
     }
+
+    static_assert(Mesh::C_LODS_MAX <= (1u << C_SORT_KEY_LOD_BITS), "Mesh levels of detail must fit in the draw sort key");
+
+    // Staged data starts on this, a multiple of the texel sizes in use and of the transfer queue's 4 byte copy offsets
+    const size_t C_STAGING_ALIGNMENT{ 16 };
+
+    // Retained entries are kept sorted with level of detail 0. Picking other levels only reorders entries whose keys
+    // differ in nothing else, so each such run is sorted on its own.
+    void sort_lod_runs(DrawSortEntry* entries, size_t count)
+    {
+        auto key_less = [](const DrawSortEntry& lhs, const DrawSortEntry& rhs) { return lhs.key < rhs.key; };
+        if(std::is_sorted(entries, entries + count, key_less))
+        {
+            return;
+        }
+
+        size_t run_begin = 0;
+        while(run_begin < count)
+        {
+            const DrawSortKey run_key = entries[run_begin].key & ~C_SORT_KEY_LOD_MASK;
+            size_t run_end = run_begin + 1;
+            while(run_end < count && (entries[run_end].key & ~C_SORT_KEY_LOD_MASK) == run_key)
+            {
+                ++run_end;
+            }
+
+            if(run_end - run_begin > 1)
+            {
+                std::sort(entries + run_begin, entries + run_end, key_less);
+            }
+
+            run_begin = run_end;
+        }
+    }
 }
 
 VulkanRenderer::VulkanRenderer(const RendInitInfo& init_info)
@@ -67,6 +111,29 @@ VulkanRenderer::VulkanRenderer(const RendInitInfo& init_info)
 
     // Add required features
     vk_init_info->features.push_back(DeviceFeature::IMAGELESS_FRAMEBUFFER);
+    vk_init_info->features.push_back(DeviceFeature::TIMELINE_SEMAPHORE);
+    vk_init_info->features.push_back(DeviceFeature::SYNCHRONIZATION_2);
+
+    // Indirect batches are drawn several at a time, each starting at its own instance
+    _indirect_draws = init_info.indirect_draws;
+    if(_indirect_draws)
+    {
+        vk_init_info->features.push_back(DeviceFeature::MULTI_DRAW_INDIRECT);
+        vk_init_info->features.push_back(DeviceFeature::DRAW_INDIRECT_FIRST_INSTANCE);
+    }
+
+    // Draw passes are timed with timestamps. The statistics queries around them need the features, inherited queries
+    // because secondaries execute while they are active; without them passes are timed only.
+    _gpu_pass_queries = init_info.gpu_pass_queries;
+    if(_gpu_pass_queries)
+    {
+        vk_init_info->optional_features.push_back(DeviceFeature::PIPELINE_STATISTICS_QUERY);
+        vk_init_info->optional_features.push_back(DeviceFeature::INHERITED_QUERIES);
+    }
+
+    _transient_bytes = init_info.transient_bytes;
+    _staging_bytes = init_info.staging_bytes;
+    _staging_bytes_max = init_info.staging_bytes_max;
 
     // Add required extensions
 #if DEBUG
@@ -83,49 +150,53 @@ VulkanRenderer::VulkanRenderer(const RendInitInfo& init_info)
     glfwSetWindowSizeCallback(_window->get_handle(), ::glfw_window_resize_callback);
     glfwSetErrorCallback(::glfw_error_callback);
 
+    _configure_frame_pacing(init_info);
+    _record_command_pools.resize(_frames_in_flight);
+    _pass_queries.resize(_frames_in_flight, nullptr);
+
     _device_context = new VulkanDeviceContext(*vk_init_info, *_window);
-    _swapchain = new Swapchain(3, *_device_context);
+    _swapchain = new Swapchain(_swapchain_images, vulkan_helpers::convert_present_mode(_present_mode), *_device_context);
 
     DescriptorPoolSize pool_sizes[] =
     {
         { DescriptorType::UNIFORM_BUFFER, 32 },
-        { DescriptorType::COMBINED_IMAGE_SAMPLER, 32 }
+        { DescriptorType::UNIFORM_BUFFER_DYNAMIC, 32 },
+        { DescriptorType::COMBINED_IMAGE_SAMPLER, 32 },
+        { DescriptorType::STORAGE_BUFFER, _frames_in_flight },
+        { DescriptorType::STORAGE_BUFFER_DYNAMIC, 32 }
     };
 
     DescriptorPoolInfo pool_info =
     {
         .pool_sizes = pool_sizes,
-        .pool_sizes_count = 2,
-        .max_sets = 9
+        .pool_sizes_count = 5,
+        .max_sets = 9 + _frames_in_flight
     };
 
     _descriptor_pool = _device_context->create_descriptor_pool(pool_info);
-    _command_pool = _device_context->create_command_pool();
 
+    DescriptorSetLayoutInfo instance_layout_info =
     {
-
-        // TODO Improve buffer creation to avoid this
-        std::vector<VulkanBuffer*> buffers;
-        for(size_t i = 0; i < _staging_buffers.capacity(); ++i)
+        .frequency = DescriptorFrequency::DRAW,
+        .layout_bindings =
         {
-            buffers.push_back(_create_staging_buffer());
+            { 0, DescriptorType::STORAGE_BUFFER, 1, ShaderStage::SHADER_STAGE_VERTEX | ShaderStage::SHADER_STAGE_FRAGMENT }
         }
+    };
 
-        for(size_t i = 0; i < _staging_buffers.capacity(); ++i)
-        {
-            _staging_buffers.release(buffers[i]->_rend_handle);
-        }
-    }
+    _instance_data_layout = create_descriptor_set_layout(C_INSTANCE_DATA_LAYOUT_NAME, instance_layout_info);
+    _command_pool = _device_context->create_command_pool();
+
+    // Shared with the application, created by rend_initialise
+    _job_system = &JobSystem::get_instance();
 }
 
 VulkanRenderer::~VulkanRenderer(void)
 {
     _device_context->get_device()->wait_idle();
 
-    for(auto& buffer : _staging_buffers)
-    {
-        _destroy_staging_buffer(&buffer);
-    }
+    delete _staging_ring;
+    delete _transient_allocator;
 
     for(auto& buffer : _buffers)
     {
@@ -172,12 +243,20 @@ VulkanRenderer::~VulkanRenderer(void)
         destroy_descriptor_set_layout(&descriptor_set_layout);
     }
 
-    for(uint32_t idx = 0; idx < _FRAMES_IN_FLIGHT; ++idx)
+    for(uint32_t idx = 0; idx < _frames_in_flight; ++idx)
     {
-        delete _frame_datas[idx].submit_fen;
-        delete _frame_datas[idx].load_sem;
+        delete _frame_datas[idx].draw_data_arena;
+        delete _pass_queries[idx];
+
+        for(auto* command_pool : _record_command_pools[idx])
+        {
+            delete command_pool;
+        }
     }
 
+    delete _upload_queue;
+    delete _frame_timeline;
+
     _device_context->destroy_command_pool(_command_pool);
     _device_context->destroy_descriptor_pool(_descriptor_pool);
 
@@ -188,18 +267,52 @@ VulkanRenderer::~VulkanRenderer(void)
 
 void VulkanRenderer::configure(void)
 {
+    // Every submit signals the next value, so a frame is complete once the timeline reaches its last submit's value
+    _frame_timeline = new TimelineSemaphore("frame timeline", _timeline_value, *_device_context);
+    _upload_queue = new VulkanUploadQueue(*_device_context, _frames_in_flight);
+    _staging_ring = new VulkanStagingRing(*_device_context, _staging_bytes, _staging_bytes_max);
+
+    if(_gpu_pass_queries && !VulkanPassQueries::is_supported(*_device_context))
+    {
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "RENDERER | Graphics queue cannot write timestamps, draw passes will not be timed");
+        _gpu_pass_queries = false;
+    }
+
+    const bool pipeline_statistics = _device_context->has_feature(DeviceFeature::PIPELINE_STATISTICS_QUERY) && _device_context->has_feature(DeviceFeature::INHERITED_QUERIES);
+    if(_gpu_pass_queries && !pipeline_statistics)
+    {
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "RENDERER | Pipeline statistics or inherited queries not supported, draw passes will be timed without statistics");
+    }
+
+    // One buffer holds every frame's transient region, so descriptors written against it stay valid for all of them.
+    // Coherent memory means nothing written through it needs flushing.
+    {
+        const auto& limits = _device_context->gpu()->get_properties().limits;
+        const BufferInfo transient_info =
+        {
+            .element_count = 1,
+            .element_size  = TransientAllocator::buffer_bytes(_transient_bytes, _frames_in_flight),
+            .usage         = BufferUsage::UNIFORM_BUFFER | BufferUsage::STORAGE_BUFFER | BufferUsage::VERTEX_BUFFER | BufferUsage::INDEX_BUFFER
+        };
+
+        const TransientAllocator::Alignments alignments =
+        {
+            static_cast<uint32_t>(limits.minUniformBufferOffsetAlignment),
+            static_cast<uint32_t>(limits.minStorageBufferOffsetAlignment),
+            16, // Vertex attributes are at most a vec4
+            4   // Indices are 32 bit
+        };
+
+        GPUBuffer* transient_buffer = _create_buffer("transient buffer", transient_info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        _transient_allocator = new TransientAllocator(*transient_buffer, static_cast<VulkanBuffer*>(transient_buffer)->mapped(), _frames_in_flight, alignments);
+    }
+
     // Setup resources for each frame in flight
-    for(uint32_t idx = 0; idx < _FRAMES_IN_FLIGHT; ++idx)
+    for(uint32_t idx = 0; idx < _frames_in_flight; ++idx)
     {
         const std::string name_prefix = "frame " + std::to_string(idx);
         std::string name{};
 
-        name = name_prefix + " load semaphore";
-        _frame_datas[idx].load_sem = new Semaphore(name, *_device_context, VK_PIPELINE_STAGE_TRANSFER_BIT);
-
-        name = name_prefix + " submit fence";
-        _frame_datas[idx].submit_fen = new Fence(name, true, *_device_context);
-
         name = name_prefix + " draw command buffer";
         _frame_datas[idx].draw_cmd = new VulkanCommandBuffer(name, _device_context->create_command_buffer(_command_pool));
 #if DEBUG
@@ -215,23 +328,53 @@ void VulkanRenderer::configure(void)
         name = name_prefix + " acquire semaphore";
         _frame_datas[idx].acquire.acquire_semaphore = new Semaphore(name, *_device_context, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
 
-        name = name_prefix + " acquire fence";
-        _frame_datas[idx].acquire.acquire_fence = new Fence(name, true, *_device_context);
+        name = name_prefix + " instance buffer";
+        _frame_datas[idx].instance_buffer = create_buffer(name, { static_cast<uint32_t>(_INSTANCE_BUFFER_BYTES), 1, BufferUsage::STORAGE_BUFFER });
+
+        name = name_prefix + " instance descriptor set";
+        _frame_datas[idx].instance_set = create_descriptor_set(name, *_instance_data_layout);
+        _frame_datas[idx].instance_set->bind_resource({ 0, DescriptorType::STORAGE_BUFFER, _frame_datas[idx].instance_buffer });
+        _frame_datas[idx].instance_set->write_bindings();
+
+        _frame_datas[idx].draw_data_arena = new LinearAllocator(_DRAW_DATA_ARENA_BYTES);
+
+        if(_indirect_draws)
+        {
+            name = name_prefix + " indirect buffer";
+            _frame_datas[idx].indirect_buffer = create_buffer(name, { static_cast<uint32_t>(_INDIRECT_BUFFER_BYTES), 1, BufferUsage::INDIRECT_BUFFER });
+        }
+
+        for(uint32_t thread_idx = 0; thread_idx < _job_system->thread_count(); ++thread_idx)
+        {
+            name = name_prefix + " record command pool " + std::to_string(thread_idx);
+            _record_command_pools[idx].push_back(new VulkanCommandPool(name, *_device_context, QueueType::GRAPHICS));
+        }
+
+        if(_gpu_pass_queries)
+        {
+            _pass_queries[idx] = new VulkanPassQueries(name_prefix + " pass queries", *_device_context, pipeline_statistics);
+        }
     }
 }
 
 void VulkanRenderer::start_frame(void)
 {
+    REND_PROFILE_ZONE("start_frame");
     // Update frame and grab next
-    _current_frame = ++_frame_counter % _FRAMES_IN_FLIGHT;
+    _current_frame = ++_frame_counter % _frames_in_flight;
     core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "RENDERER | Starting frame: " + std::to_string(_frame_counter));
 
     auto& frame_res = _frame_datas[_current_frame];
     frame_res.frame = _frame_counter;
 
     // Wait for previous submit of this frame to be complete
-    frame_res.submit_fen->wait();
-    frame_res.submit_fen->reset();
+    _frame_timeline->wait(frame_res.submit_value);
+
+    // Its queries are done too, so reading them cannot stall
+    if(_pass_queries[_current_frame])
+    {
+        _pass_queries[_current_frame]->read_results(_gpu_pass_timings);
+    }
 
     if(_need_resize)
     {
@@ -254,14 +397,22 @@ void VulkanRenderer::start_frame(void)
         }
     }
 
-    // Release staging buffers from previous usage of this FrameData
-    for(auto* staging_buffer : frame_res.staging_buffers_used)
+    // Free staging memory from any upload the GPU has finished with, not only this frame's
+    _upload_queue->start_frame(_current_frame);
+    _staging_ring->release(_upload_queue->get_completed_value());
+
+    // Draw data from this frame's last use has been consumed
+    frame_res.draw_data_arena->reset();
+
+    // Transient regions turn over with the frames in flight, the one coming up was last used by the frame just waited for
+    _transient_allocator->start_frame();
+
+    // Secondary command buffers from this frame's last use are done with
+    for(auto* command_pool : _record_command_pools[_current_frame])
     {
-        _staging_buffers.release(staging_buffer->rend_handle());
+        command_pool->reset();
     }
 
-    frame_res.staging_buffers_used.clear();
-
     auto* load_cmd = static_cast<VulkanCommandBuffer*>(frame_res.load_cmd);
     load_cmd->reset();
     load_cmd->begin();
@@ -269,35 +420,71 @@ void VulkanRenderer::start_frame(void)
     auto* draw_cmd = static_cast<VulkanCommandBuffer*>(frame_res.draw_cmd);
     draw_cmd->reset();
     draw_cmd->begin();
+
+    if(_pass_queries[_current_frame])
+    {
+        _pass_queries[_current_frame]->reset(*draw_cmd);
+    }
+
+    draw_cmd->set_pass_queries(_pass_queries[_current_frame]);
 }
 
 void VulkanRenderer::end_frame(void)
 {
+    REND_PROFILE_ZONE("end_frame");
     core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "RENDERER | Ending frame: " + std::to_string(_frame_counter));
     FrameData& frame_res = _frame_datas[_current_frame];
 
-    std::vector<Semaphore*> draw_wait_sems;
-    draw_wait_sems.push_back(frame_res.acquire.acquire_semaphore);
+    std::vector<TimelinePoint> draw_timeline_waits;
 
-    if(!_pre_render_queue.empty())
+    if(!_pre_render_commands.empty() || !_load_barriers.empty() || !_pending_uploads.empty())
     {
-        _process_pre_render_tasks();
+        _process_pre_render_commands();
         auto* load_cmd = static_cast<VulkanCommandBuffer*>(frame_res.load_cmd);
+
+        // Uploads go to the transfer queue, the load submit only takes ownership of what they wrote
+        std::vector<TimelinePoint> load_timeline_waits;
+        if(_upload_queue->has_uploads())
+        {
+            TimelinePoint upload_point = _upload_queue->submit(*load_cmd);
+            load_timeline_waits.push_back(upload_point);
+            draw_timeline_waits.push_back(upload_point);
+
+            // Staging memory read by the upload is free again once the upload timeline passes it
+            _staging_ring->retire(upload_point.value);
+        }
+
+        // After the acquires, so textures uploaded this frame are owned by graphics before they transition
+        _load_barriers.flush(*load_cmd);
         load_cmd->end();
-        _device_context->queue_submit(*load_cmd, QueueType::GRAPHICS, {}, { frame_res.load_sem }, nullptr);
-        draw_wait_sems.push_back(frame_res.load_sem);
+
+        TimelinePoint load_point{ _frame_timeline, ++_timeline_value, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+        _device_context->queue_submit(*load_cmd, QueueType::GRAPHICS, {}, {}, load_timeline_waits, { load_point }, nullptr);
+        draw_timeline_waits.push_back(load_point);
     }
 
     auto* draw_cmd = static_cast<VulkanCommandBuffer*>(frame_res.draw_cmd);
     _process_draw_items();
     draw_cmd->end();
 
+    _command_buffer_stats = draw_cmd->get_stats();
+    _command_buffer_stats += frame_res.load_cmd->get_stats();
+    _command_buffer_stats += _upload_queue->get_stats();
+    for(auto& job : _record_jobs)
+    {
+        _command_buffer_stats += job.command_buffer->get_stats();
+    }
+
+    frame_res.submit_value = ++_timeline_value;
+
     _device_context->queue_submit(
         *draw_cmd,
         QueueType::GRAPHICS,
-        draw_wait_sems,
+        { frame_res.acquire.acquire_semaphore },
         { _swapchain->get_present_resources(frame_res.acquire).semaphore },
-        frame_res.submit_fen
+        draw_timeline_waits,
+        { { _frame_timeline, frame_res.submit_value } },
+        nullptr
     );
 
     _swapchain->present(QueueType::GRAPHICS);
@@ -326,95 +513,57 @@ void VulkanRenderer::get_size_by_ratio(SizeRatio size_ratio, uint32_t& width, ui
 
 void VulkanRenderer::load_texture(GPUTexture& texture)
 {
-    _pre_render_queue.push(
-        [this, &texture]()
-        {
-            FrameData& fr = _frame_datas[_current_frame];
-            VulkanCommandBuffer* cmd = static_cast<VulkanCommandBuffer*>(fr.load_cmd);
-            void* mapped = NULL;
-
-            transition(texture, PipelineStage::PIPELINE_STAGE_TOP_OF_PIPE, PipelineStage::PIPELINE_STAGE_TRANSFER, ImageLayout::TRANSFER_DST);
-
-            auto  staging_buffer_h = _staging_buffers.acquire();
-            VulkanBuffer* staging_buffer = _staging_buffers.get(staging_buffer_h);
-
-            mapped = _device_context->map_buffer_memory(*staging_buffer, staging_buffer->bytes());
-            memcpy(mapped, texture.data(), texture.bytes());
-            _device_context->unmap_buffer_memory(*staging_buffer);
+    PreRenderCommand command{};
+    command.type    = PreRenderCommandType::TEXTURE_UPLOAD;
+    command.texture = &texture;
 
-            BufferImageCopyInfo info =
-            {
-                .buffer_offset  = 0,
-                .buffer_width   = texture.width(),
-                .buffer_height  = texture.height(),
-                .image_offset_x = 0,
-                .image_offset_y = 0,
-                .image_offset_z = 0,
-                .image_width    = texture.width(),
-                .image_height   = texture.height(),
-                .image_depth    = texture.depth(),
-                .image_layout   = texture.layout(),
-                .mip_level      = 0,
-                .base_layer     = 0,
-                .layer_count    = texture.layers()
-            };
+    _pre_render_commands.push(command);
+}
 
-            cmd->copy(*staging_buffer, texture, info);
-            transition(texture, PipelineStage::PIPELINE_STAGE_TRANSFER, PipelineStage::PIPELINE_STAGE_FRAGMENT_SHADER, ImageLayout::SHADER_READ_ONLY);
+void VulkanRenderer::load_buffer(GPUBuffer& buffer)
+{
+    PreRenderCommand command{};
+    command.type   = PreRenderCommandType::BUFFER_UPLOAD;
+    command.buffer = &buffer;
 
-            fr.staging_buffers_used.push_back(staging_buffer);
-        });
+    _pre_render_commands.push(command);
 }
 
-void VulkanRenderer::load_buffer(GPUBuffer& buffer)
+void VulkanRenderer::execute_render_graph(const RenderGraph& render_graph)
 {
-    _pre_render_queue.push(
-        [this, &buffer]()
+    REND_PROFILE_ZONE("execute_render_graph");
+    FrameData& fr = _frame_datas[_current_frame];
+    auto* draw_cmd = static_cast<VulkanCommandBuffer*>(fr.draw_cmd);
+
+    for(RenderGraphPass pass : render_graph.get_pass_order())
+    {
+        // The graph's source scope covers reads it ran without a barrier, which the textures' tracked state missed
+        for(const RenderGraphBarrier& barrier : render_graph.get_barriers(pass))
         {
-            // TODO: This should be based on the memory properties, not the resource
-            bool is_device_local{ false };
-            if ((buffer.usage() & BufferUsage::VERTEX_BUFFER) != BufferUsage::NONE ||
-                (buffer.usage() & BufferUsage::INDEX_BUFFER)  != BufferUsage::NONE)
-            {
-                is_device_local = true;
-            }
+            GPUTexture* texture = render_graph.get_texture(barrier.resource);
+            assert(texture && "Render graph resource has no texture");
 
-            if(is_device_local)
+            VulkanImageTransition transition =
             {
-                FrameData& fr = _frame_datas[_current_frame];
-                auto staging_buffer_h = _staging_buffers.acquire();
-                GPUBuffer* staging_buffer = _staging_buffers.get(staging_buffer_h);
-                CommandBuffer* cmd = fr.load_cmd;
-
-                void* mapped = _device_context->map_buffer_memory(*staging_buffer, staging_buffer->bytes());
-                memcpy(mapped, buffer.data(), buffer.bytes());
-                _device_context->unmap_buffer_memory(*staging_buffer);
-
-                BufferBufferCopyInfo info =
-                {
-                    .size_bytes = (uint32_t)buffer.bytes(),
-                    .src_offset = 0,
-                    .dst_offset = 0
-                };
+                .layout       = vulkan_helpers::convert_image_layout(barrier.new_layout),
+                .stages       = vulkan_helpers::convert_pipeline_stages(barrier.dst_stages),
+                .accesses     = vulkan_helpers::convert_memory_accesses(barrier.dst_accesses),
+                .src_stages   = vulkan_helpers::convert_pipeline_stages(barrier.src_stages),
+                .src_accesses = vulkan_helpers::convert_memory_accesses(barrier.src_accesses)
+            };
 
-                cmd->copy(*staging_buffer, buffer, info);
+            _draw_barriers.transition(static_cast<VulkanTexture&>(*texture), transition);
+        }
 
-                fr.staging_buffers_used.push_back(staging_buffer);
-            }
-            else
-            {
-                void* mapped = _device_context->map_buffer_memory(buffer, buffer.bytes());
-                memcpy(mapped, buffer.data(), buffer.bytes());
-                _device_context->unmap_buffer_memory(buffer);
-            }
-        });
+        _draw_barriers.flush(*draw_cmd);
+        render_graph.execute_pass(pass, *draw_cmd);
+    }
 }
 
 void VulkanRenderer::transition(GPUTexture& texture, PipelineStages src, PipelineStages dst, ImageLayout final_layout)
 {
-    FrameData& fr = _frame_datas[_current_frame];
-    VulkanCommandBuffer* vk_cmd = static_cast<VulkanCommandBuffer*>(fr.load_cmd);
-    vk_cmd->transition_image(texture, src, dst, final_layout);
+    // Recorded into the load command buffer with every other transition this frame by end_frame
+    VulkanCommandBuffer::transition_image(_load_barriers, texture, src, dst, final_layout);
 }
 
 void VulkanRenderer::write_descriptor_bindings(const DescriptorSet& descriptor_set)
@@ -512,136 +661,955 @@ VulkanDeviceContext* VulkanRenderer::device_context(void) const
     return _device_context;
 }
 
-void VulkanRenderer::_process_pre_render_tasks(void)
+void VulkanRenderer::_process_pre_render_commands(void)
 {
-    std::queue<std::function<void(void)>> process;
-    std::swap(_pre_render_queue, process);
+    REND_PROFILE_ZONE("pre_render_commands");
+    std::swap(_pre_render_commands, _pre_render_commands_processing);
 
-    while(!process.empty())
+    for(const PreRenderCommand& command : _pre_render_commands_processing.coalesce())
     {
-        process.front()();
-        process.pop();
+        switch(command.type)
+        {
+            case PreRenderCommandType::BUFFER_UPLOAD:
+                _upload_buffer(*command.buffer); break;
+            case PreRenderCommandType::TEXTURE_UPLOAD:
+                _queue_upload(nullptr, command.texture); break;
+            case PreRenderCommandType::TRANSITION:
+                transition(*command.texture, command.src_stages, command.dst_stages, command.layout); break;
+            case PreRenderCommandType::CALLBACK:
+                command.callback(command.user_data); break;
+        }
     }
+
+    _pre_render_commands_processing.clear();
+    _stage_pending_uploads();
+    _write_staging_copies();
 }
 
-std::unordered_map<View*, std::unordered_map<RenderStrategy*, std::vector<DrawItem*>>> VulkanRenderer::_sort_draw_items(void)
+void VulkanRenderer::_write_staging_copies(void)
 {
-    std::unordered_map<View*, 
-        std::unordered_map<
-            RenderStrategy*, std::vector<DrawItem*>>> sorted_items;
+    REND_PROFILE_ZONE("staging_copies");
+    // Every upload has its own destination, so the copies run in parallel and only flushing is serial
+    _job_system->parallel_for(
+        static_cast<uint32_t>(_staging_copies.size()),
+        [this](uint32_t copy_idx, uint32_t thread_idx)
+        {
+            (void)thread_idx;
+            const StagingCopy& copy = _staging_copies[copy_idx];
+            memcpy(copy.dst, copy.src, copy.bytes);
+        });
 
-    //// Sort the draw items
-    //std::sort(_draw_items.begin(), _draw_items.end(), [this](DrawItem& item1, DrawItem& item2)
-    //{
-    //    const MaterialInfo& mat1 = this->get_material(item1.material)->get_info();
-    //    const MaterialInfo& mat2 = this->get_material(item2.material)->get_info();
+    for(const StagingCopy& copy : _staging_copies)
+    {
+        if(copy.flush_buffer != nullptr)
+        {
+            _device_context->flush_buffer_memory(*copy.flush_buffer, 0, copy.bytes);
+        }
+    }
+
+    _staging_copies.clear();
+}
+
+void VulkanRenderer::_upload_buffer(GPUBuffer& buffer)
+{
+    // TODO: This should be based on the memory properties, not the resource
+    bool is_device_local{ false };
+    if ((buffer.usage() & BufferUsage::VERTEX_BUFFER) != BufferUsage::NONE ||
+        (buffer.usage() & BufferUsage::INDEX_BUFFER)  != BufferUsage::NONE)
+    {
+        is_device_local = true;
+    }
+
+    if(is_device_local)
+    {
+        _queue_upload(&buffer, nullptr);
+    }
+    else
+    {
+        // Written straight into the buffer's own memory
+        _staging_copies.push_back({ static_cast<VulkanBuffer&>(buffer).mapped(), buffer.data(), buffer.bytes(), &buffer });
+    }
+}
+
+void VulkanRenderer::_queue_upload(GPUBuffer* buffer, GPUTexture* texture)
+{
+    // New data for a resource still being staged starts its upload again, keeping its place in the queue
+    for(PendingUpload& upload : _pending_uploads)
+    {
+        if(upload.buffer == buffer && upload.texture == texture)
+        {
+            upload.bytes_staged = 0;
+            return;
+        }
+    }
+
+    _pending_uploads.push_back({ buffer, texture, 0 });
+}
+
+void VulkanRenderer::_stage_pending_uploads(void)
+{
+    // In the order they were queued, so an upload split over frames is not starved by newer ones
+    size_t kept = 0;
+    for(PendingUpload& upload : _pending_uploads)
+    {
+        const bool staged = upload.buffer != nullptr
+            ? _stage_buffer(*upload.buffer, upload.bytes_staged)
+            : _stage_texture(*upload.texture, upload.bytes_staged);
+
+        if(!staged)
+        {
+            _pending_uploads[kept++] = upload;
+        }
+    }
+
+    _pending_uploads.resize(kept);
+}
+
+bool VulkanRenderer::_stage_buffer(GPUBuffer& buffer, size_t& bytes_staged)
+{
+    const size_t bytes = buffer.bytes() - bytes_staged;
+    const StagingAllocation staging = _staging_ring->allocate(bytes, C_STAGING_ALIGNMENT, C_STAGING_ALIGNMENT);
+    if(staging.bytes == 0)
+    {
+        return false;
+    }
+
+    // Written by _write_staging_copies, before the upload is submitted
+    _staging_copies.push_back({ staging.data, static_cast<const char*>(buffer.data()) + bytes_staged, staging.bytes, nullptr });
+
+    BufferBufferCopyInfo info =
+    {
+        .size_bytes = staging.bytes,
+        .src_offset = staging.offset,
+        .dst_offset = static_cast<uint32_t>(bytes_staged)
+    };
+
+    _upload_queue->upload(*staging.buffer, buffer, info);
+
+    bytes_staged += staging.bytes;
+    return bytes_staged == buffer.bytes();
+}
+
+bool VulkanRenderer::_stage_texture(GPUTexture& texture, size_t& bytes_staged)
+{
+    // Rows of every depth slice of every layer, in the order the texture's data holds them
+    const uint32_t depth      = std::max(texture.depth(), 1u);
+    const size_t   slice_rows = texture.height();
+    const size_t   row_bytes  = texture.bytes() / (slice_rows * depth * texture.layers());
+
+    const size_t bytes      = texture.bytes() - bytes_staged;
+    const size_t unit_bytes = _upload_queue->texture_split_rows(texture) * row_bytes;
+    const StagingAllocation staging = _staging_ring->allocate(bytes, C_STAGING_ALIGNMENT, unit_bytes);
+    if(staging.bytes == 0)
+    {
+        // Waiting only helps if the transfer granularity's smallest part can be staged at all
+        if(!_staging_ring->fits(unit_bytes))
+        {
+            core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "RENDERER | Dropped upload of texture " + texture.name() + ", its transfer granularity needs " + std::to_string(unit_bytes) + " bytes staged at once");
+            return true;
+        }
+
+        return false;
+    }
+
+    _staging_copies.push_back({ staging.data, static_cast<const char*>(texture.data()) + bytes_staged, staging.bytes, nullptr });
+
+    const bool first_part = bytes_staged == 0;
+    const bool last_part  = staging.bytes == bytes;
+    bytes_staged += staging.bytes;
+
+    if(first_part && last_part)
+    {
+        BufferImageCopyInfo info =
+        {
+            .buffer_offset  = staging.offset,
+            .buffer_width   = texture.width(),
+            .buffer_height  = texture.height(),
+            .image_offset_x = 0,
+            .image_offset_y = 0,
+            .image_offset_z = 0,
+            .image_width    = texture.width(),
+            .image_height   = texture.height(),
+            .image_depth    = depth,
+            .image_layout   = ImageLayout::TRANSFER_DST,
+            .mip_level      = 0,
+            .base_layer     = 0,
+            .layer_count    = texture.layers()
+        };
+
+        _upload_queue->upload(*staging.buffer, texture, info, true, true);
+        return true;
+    }
+
+    // A part is a run of rows, copied as one region for each depth slice and layer it touches
+    const size_t rows_begin   = (bytes_staged - staging.bytes) / row_bytes;
+    const size_t rows_end     = bytes_staged / row_bytes;
+    const size_t slices_begin = rows_begin / slice_rows;
+    const size_t slices_end   = (rows_end + slice_rows - 1) / slice_rows;
+
+    for(size_t slice = slices_begin; slice < slices_end; ++slice)
+    {
+        const size_t slice_begin = slice * slice_rows;
+        const size_t y_begin     = std::max(rows_begin, slice_begin) - slice_begin;
+        const size_t y_end       = std::min(rows_end, slice_begin + slice_rows) - slice_begin;
+
+        BufferImageCopyInfo info =
+        {
+            .buffer_offset  = static_cast<uint32_t>(staging.offset + (slice_begin + y_begin - rows_begin) * row_bytes),
+            .buffer_width   = texture.width(),
+            .buffer_height  = static_cast<uint32_t>(y_end - y_begin),
+            .image_offset_x = 0,
+            .image_offset_y = static_cast<int32_t>(y_begin),
+            .image_offset_z = static_cast<int32_t>(slice % depth),
+            .image_width    = texture.width(),
+            .image_height   = static_cast<uint32_t>(y_end - y_begin),
+            .image_depth    = 1,
+            .image_layout   = ImageLayout::TRANSFER_DST,
+            .mip_level      = 0,
+            .base_layer     = static_cast<uint32_t>(slice / depth),
+            .layer_count    = 1
+        };
+
+        _upload_queue->upload(*staging.buffer, texture, info, first_part && slice == slices_begin, last_part && slice + 1 == slices_end);
+    }
 
-    //    return mat1.render_pass_h < mat2.render_pass_h;
-    //});
+    return last_part;
+}
 
-    for(size_t i = 0; i < _draw_items.size(); ++i)
+void VulkanRenderer::_update_retained_draw_items(void)
+{
+    // Drop entries of removed and updated items, the rest stay in order
+    if(_retained_stale_count > 0)
     {
-        DrawItem& draw_item = _draw_items[i];
-        Material* m = draw_item.material;
-        View* v = draw_item.view;
+        std::erase_if(
+            _retained_sort_entries,
+            [this](const DrawSortEntry& entry)
+            {
+                return _retained_draw_item_flags[entry.item_idx & ~C_SORT_ENTRY_RETAINED_BIT] & _RETAINED_DRAW_ITEM_STALE;
+            });
+
+        for(auto& flags : _retained_draw_item_flags)
+        {
+            flags &= ~_RETAINED_DRAW_ITEM_STALE;
+        }
+
+        _retained_stale_count = 0;
+    }
 
-        sorted_items[v][m->get_material_info().render_strategy].push_back(&_draw_items[i]);
+    if(_retained_dirty_handles.empty())
+    {
+        return;
     }
 
-    return sorted_items;
+    // Sort only the added and updated items, then merge them into the already sorted entries
+    const size_t retained_count = _retained_sort_entries.size();
+    _retained_sort_entries.reserve(retained_count + _retained_dirty_handles.size());
+
+    for(RendHandle handle : _retained_dirty_handles)
+    {
+        // Handles removed after being dirtied are no longer valid
+        const uint32_t* slot = _retained_draw_item_handles.get(handle);
+        if(!slot)
+        {
+            continue;
+        }
+
+        _retained_draw_item_flags[*slot] &= ~_RETAINED_DRAW_ITEM_DIRTY;
+
+        DrawSortEntry& entry = _retained_sort_entries.emplace_back();
+        entry.key = _retained_draw_items.keys[*slot];
+        entry.item_idx = *slot | C_SORT_ENTRY_RETAINED_BIT;
+    }
+
+    _retained_dirty_handles.clear();
+
+    const size_t dirty_count = _retained_sort_entries.size() - retained_count;
+    _retained_sort_scratch.resize(_retained_sort_entries.size());
+
+    radix_sort(_retained_sort_entries.data() + retained_count, _retained_sort_scratch.data(), dirty_count);
+
+    std::merge(
+        _retained_sort_entries.begin(), _retained_sort_entries.begin() + retained_count,
+        _retained_sort_entries.begin() + retained_count, _retained_sort_entries.end(),
+        _retained_sort_scratch.begin(),
+        [](const DrawSortEntry& lhs, const DrawSortEntry& rhs) { return lhs.key < rhs.key; });
+
+    std::swap(_retained_sort_entries, _retained_sort_scratch);
+}
+
+void VulkanRenderer::_write_cull_item(uint32_t idx, const Mesh* mesh, View* view, const glm::mat4* transform)
+{
+    BoundingSphere sphere{ glm::vec3(0.0f), std::numeric_limits<float>::infinity() };
+    if(transform && mesh->has_bounds())
+    {
+        sphere = transform_bounding_sphere(mesh->get_bounding_sphere(), *transform);
+    }
+
+    _cull_spheres.x[idx] = sphere.centre.x;
+    _cull_spheres.y[idx] = sphere.centre.y;
+    _cull_spheres.z[idx] = sphere.centre.z;
+    _cull_spheres.radius[idx] = sphere.radius;
+    _cull_meshes[idx] = mesh;
+    _cull_views[idx] = view;
+}
+
+void VulkanRenderer::_select_lods(uint32_t begin, uint32_t end, const View& view)
+{
+    std::fill(_cull_lods.begin() + begin, _cull_lods.begin() + end, 0);
+
+    if(!view.has_lod_projection())
+    {
+        return;
+    }
+
+    for(uint32_t idx = begin; idx < end; ++idx)
+    {
+        const Mesh* mesh = _cull_meshes[idx];
+        const float radius = _cull_spheres.radius[idx];
+        const float mesh_radius = mesh->get_bounding_sphere().radius;
+
+        // Items that cannot be culled have no world bounds to measure either
+        if(!_cull_visible[idx] || mesh->get_lods_count() < 2 || std::isinf(radius) || mesh_radius <= 0.0f)
+        {
+            continue;
+        }
+
+        const glm::vec3 centre{ _cull_spheres.x[idx], _cull_spheres.y[idx], _cull_spheres.z[idx] };
+        const float distance = glm::length(centre - view.get_eye_position()) - radius;
+
+        _cull_lods[idx] = static_cast<uint8_t>(select_lod(mesh->get_lods(), radius / mesh_radius, distance, view.get_projection_scale(), _lod_error_threshold));
+    }
+}
+
+void VulkanRenderer::_build_view_jobs(void)
+{
+    static constexpr uint32_t C_VIEW_SLOTS{ _VIEWS_MAX };
+
+    // Keys lead with the view, so counting items per view slot splits the frame into views in sorted order
+    std::array<uint32_t, C_VIEW_SLOTS> transient_counts{};
+    std::array<uint32_t, C_VIEW_SLOTS> retained_counts{};
+
+    uint32_t transient_count = 0;
+    for(auto* draw_items : _draw_item_lists)
+    {
+        for(DrawSortKey key : draw_items->keys)
+        {
+            ++transient_counts[key >> C_SORT_KEY_VIEW_SHIFT];
+        }
+
+        transient_count += draw_items->size();
+    }
+
+    for(const DrawSortEntry& entry : _retained_sort_entries)
+    {
+        ++retained_counts[entry.key >> C_SORT_KEY_VIEW_SHIFT];
+    }
+
+    // Each view's transient items followed by its retained items take one contiguous region of the cull arrays
+    std::array<uint32_t, C_VIEW_SLOTS> transient_offsets{};
+    uint32_t cull_offset = 0;
+    uint32_t transient_offset = 0;
+    uint32_t retained_offset = 0;
+
+    _view_jobs.clear();
+    for(uint32_t slot = 0; slot < C_VIEW_SLOTS; ++slot)
+    {
+        transient_offsets[slot] = transient_offset;
+
+        if(transient_counts[slot] + retained_counts[slot] == 0)
+        {
+            continue;
+        }
+
+        ViewJob& job = _view_jobs.emplace_back();
+        job.cull_begin = cull_offset;
+        job.transient_begin = transient_offset;
+        job.transient_count = transient_counts[slot];
+        job.retained_begin = retained_offset;
+        job.retained_count = retained_counts[slot];
+
+        cull_offset += transient_counts[slot] + retained_counts[slot];
+        transient_offset += transient_counts[slot];
+        retained_offset += retained_counts[slot];
+    }
+
+    _view_items.resize(transient_count);
+    for(uint32_t list_idx = 0; list_idx < _draw_item_lists.size(); ++list_idx)
+    {
+        const DrawItemList& draw_items = *_draw_item_lists[list_idx];
+        for(uint32_t item_idx = 0; item_idx < draw_items.size(); ++item_idx)
+        {
+            _view_items[transient_offsets[draw_items.keys[item_idx] >> C_SORT_KEY_VIEW_SHIFT]++] = { list_idx, item_idx };
+        }
+    }
+
+    // Resizing keeps capacity, so only frames with more items than any before allocate
+    _cull_spheres.resize(cull_offset);
+    _cull_visible.resize(cull_offset);
+    _cull_meshes.resize(cull_offset);
+    _cull_views.resize(cull_offset);
+    _cull_lods.resize(cull_offset);
+    _draw_sort_entries.resize(cull_offset);
+    _draw_sort_scratch.resize(cull_offset);
+    _retained_visible_entries.resize(cull_offset);
+}
+
+void VulkanRenderer::_cull_and_sort_view(uint32_t job_idx)
+{
+    REND_PROFILE_ZONE("cull_and_sort_view");
+    ViewJob& job = _view_jobs[job_idx];
+    const uint32_t retained_cull_begin = job.cull_begin + job.transient_count;
+    const uint32_t cull_end = retained_cull_begin + job.retained_count;
+
+    for(uint32_t i = 0; i < job.transient_count; ++i)
+    {
+        const ViewItem& view_item = _view_items[job.transient_begin + i];
+        const DrawItemList& draw_items = *_draw_item_lists[view_item.list_idx];
+        _write_cull_item(job.cull_begin + i, draw_items.meshes[view_item.item_idx], draw_items.views[view_item.item_idx], draw_items.transforms[view_item.item_idx]);
+    }
+
+    for(uint32_t i = 0; i < job.retained_count; ++i)
+    {
+        const uint32_t slot = _retained_sort_entries[job.retained_begin + i].item_idx & ~C_SORT_ENTRY_RETAINED_BIT;
+        _write_cull_item(retained_cull_begin + i, _retained_draw_items.meshes[slot], _retained_draw_items.views[slot], _retained_draw_items.transforms[slot]);
+    }
+
+    View& view = *_cull_views[job.cull_begin];
+    if(const Frustum* frustum = view.get_frustum())
+    {
+        cull_spheres(*frustum, _cull_spheres, job.cull_begin, cull_end - job.cull_begin, _cull_visible.data());
+    }
+    else
+    {
+        std::fill(_cull_visible.begin() + job.cull_begin, _cull_visible.begin() + cull_end, 1);
+    }
+
+    _select_lods(job.cull_begin, cull_end, view);
+
+    // Sort the visible transient items, using this view's region of the output as scratch
+    DrawSortEntry* transient_entries = _draw_sort_scratch.data() + job.cull_begin;
+    uint32_t transient_visible = 0;
+    for(uint32_t i = 0; i < job.transient_count; ++i)
+    {
+        if(!_cull_visible[job.cull_begin + i])
+        {
+            continue;
+        }
+
+        const ViewItem& view_item = _view_items[job.transient_begin + i];
+        transient_entries[transient_visible].key = set_sort_key_lod(_draw_item_lists[view_item.list_idx]->keys[view_item.item_idx], _cull_lods[job.cull_begin + i]);
+        transient_entries[transient_visible].item_idx = job.transient_begin + i;
+        ++transient_visible;
+    }
+
+    radix_sort(transient_entries, _draw_sort_entries.data() + job.cull_begin, transient_visible);
+
+    DrawSortEntry* retained_entries = _retained_visible_entries.data() + job.cull_begin;
+    uint32_t retained_visible = 0;
+    for(uint32_t i = 0; i < job.retained_count; ++i)
+    {
+        if(!_cull_visible[retained_cull_begin + i])
+        {
+            continue;
+        }
+
+        retained_entries[retained_visible] = _retained_sort_entries[job.retained_begin + i];
+        retained_entries[retained_visible].key = set_sort_key_lod(retained_entries[retained_visible].key, _cull_lods[retained_cull_begin + i]);
+        ++retained_visible;
+    }
+
+    sort_lod_runs(retained_entries, retained_visible);
+
+    // Retained entries go first on equal keys so the order is stable from frame to frame
+    std::merge(
+        retained_entries, retained_entries + retained_visible,
+        transient_entries, transient_entries + transient_visible,
+        _draw_sort_entries.data() + job.cull_begin,
+        [](const DrawSortEntry& lhs, const DrawSortEntry& rhs) { return lhs.key < rhs.key; });
+
+    job.visible_count = transient_visible + retained_visible;
+}
+
+void VulkanRenderer::_gather_sorted_view(uint32_t job_idx)
+{
+    const ViewJob& job = _view_jobs[job_idx];
+
+    for(uint32_t i = 0; i < job.visible_count; ++i)
+    {
+        const DrawSortEntry& entry = _draw_sort_entries[job.cull_begin + i];
+        const uint32_t sorted_idx = job.sorted_begin + i;
+
+        if(entry.item_idx & C_SORT_ENTRY_RETAINED_BIT)
+        {
+            _sorted_draw_items.copy(sorted_idx, _retained_draw_items, entry.item_idx & ~C_SORT_ENTRY_RETAINED_BIT);
+        }
+        else
+        {
+            const ViewItem& view_item = _view_items[entry.item_idx];
+            _sorted_draw_items.copy(sorted_idx, *_draw_item_lists[view_item.list_idx], view_item.item_idx);
+        }
+
+        // Keep the level of detail picked this frame
+        _sorted_draw_items.keys[sorted_idx] = entry.key;
+    }
+}
+
+void VulkanRenderer::_sort_draw_items(void)
+{
+    REND_PROFILE_ZONE("sort_draw_items");
+    _update_retained_draw_items();
+    _build_view_jobs();
+
+    // Views are culled and sorted independently, each into its own region. Laying them out needs every view's
+    // visible count, then each view gathers into its region independently again.
+    const uint32_t jobs_count = static_cast<uint32_t>(_view_jobs.size());
+    Job* cull_job = _job_system->create_parallel_for(
+        jobs_count,
+        [this](uint32_t job_idx, uint32_t thread_idx)
+        {
+            (void)thread_idx;
+            _cull_and_sort_view(job_idx);
+        });
+
+    Job* layout_job = _job_system->create_job(
+        [this](uint32_t thread_idx)
+        {
+            (void)thread_idx;
+
+            // Views follow each other in key order, so laying them out back to back keeps the whole list sorted
+            uint32_t sorted_count = 0;
+            for(auto& job : _view_jobs)
+            {
+                job.sorted_begin = sorted_count;
+                sorted_count += job.visible_count;
+            }
+
+            _cull_stats.draw_items_submitted = static_cast<uint32_t>(_cull_visible.size());
+            _cull_stats.draw_items_visible = sorted_count;
+            _sorted_draw_items.resize(sorted_count);
+        });
+
+    // Gather into sorted order once, so every later stage walks the arrays front to back
+    Job* gather_job = _job_system->create_parallel_for(
+        jobs_count,
+        [this](uint32_t job_idx, uint32_t thread_idx)
+        {
+            (void)thread_idx;
+            _gather_sorted_view(job_idx);
+        });
+
+    _job_system->add_dependency(layout_job, cull_job);
+    _job_system->add_dependency(gather_job, layout_job);
+    _job_system->submit(gather_job);
+    _job_system->submit(layout_job);
+    _job_system->submit(cull_job);
+    _job_system->wait(gather_job);
+}
+
+void VulkanRenderer::_build_draw_batches(void)
+{
+    FrameData& frame_res = _frame_datas[_current_frame];
+    const DrawItemList& items = _sorted_draw_items;
+
+    _draw_batches.clear();
+
+    // Sorted items with equal keys share view, material and mesh, so each run becomes one instanced draw.
+    // Each batch lays its instance data out at its own stride, so gl_InstanceIndex indexes straight into it.
+    const uint32_t count = items.size();
+    size_t instance_bytes = 0;
+    uint32_t batch_begin = 0;
+
+    while(batch_begin < count)
+    {
+        const PerDrawData& first_data = items.per_draw_datas[batch_begin];
+
+        uint32_t batch_end = batch_begin + 1;
+        while(batch_end < count && items.keys[batch_end] == items.keys[batch_begin])
+        {
+            const PerDrawData& data = items.per_draw_datas[batch_end];
+            if(items.meshes[batch_end] != items.meshes[batch_begin] ||
+               items.materials[batch_end] != items.materials[batch_begin] ||
+               items.views[batch_end] != items.views[batch_begin] ||
+               data.bytes != first_data.bytes || data.stages != first_data.stages)
+            {
+                break;
+            }
+
+            ++batch_end;
+        }
+
+        DrawBatch& batch = _draw_batches.emplace_back();
+        batch.items_begin = batch_begin;
+        batch.items_end = batch_end;
+        batch.instance_stride = static_cast<uint32_t>(align_up(first_data.bytes, constants::instance_data_alignment));
+
+        if(batch.instance_stride > 0)
+        {
+            const size_t first_offset = align_up(instance_bytes, batch.instance_stride);
+            batch.first_instance = static_cast<uint32_t>(first_offset / batch.instance_stride);
+            instance_bytes = first_offset + (batch_end - batch_begin) * batch.instance_stride;
+        }
+
+        batch_begin = batch_end;
+    }
+
+    if(instance_bytes == 0)
+    {
+        return;
+    }
+
+    if(instance_bytes > frame_res.instance_buffer->bytes())
+    {
+        _resize_instance_buffer(frame_res, instance_bytes);
+    }
+
+    char* mapped = static_cast<char*>(static_cast<VulkanBuffer*>(frame_res.instance_buffer)->mapped());
+
+    for(auto& batch : _draw_batches)
+    {
+        char* dst = mapped + static_cast<size_t>(batch.first_instance) * batch.instance_stride;
+        for(uint32_t item_idx = batch.items_begin; item_idx < batch.items_end; ++item_idx)
+        {
+            const PerDrawData& per_draw_data = items.per_draw_datas[item_idx];
+            memcpy(dst, per_draw_data.data, per_draw_data.bytes);
+            dst += batch.instance_stride;
+        }
+    }
+
+    _device_context->flush_buffer_memory(*frame_res.instance_buffer, 0, instance_bytes);
+}
+
+void VulkanRenderer::_write_indirect_commands(void)
+{
+    FrameData& frame_res = _frame_datas[_current_frame];
+
+    // One command per batch, indexed by batch, so consecutive batches can be drawn with one call
+    const size_t indirect_bytes = _draw_batches.size() * sizeof(VkDrawIndexedIndirectCommand);
+    if(indirect_bytes == 0)
+    {
+        return;
+    }
+
+    if(indirect_bytes > frame_res.indirect_buffer->bytes())
+    {
+        frame_res.indirect_buffer = _grow_buffer(frame_res.indirect_buffer, indirect_bytes, BufferUsage::INDIRECT_BUFFER);
+    }
+
+    auto* commands = static_cast<VkDrawIndexedIndirectCommand*>(static_cast<VulkanBuffer*>(frame_res.indirect_buffer)->mapped());
+
+    for(size_t batch_idx = 0; batch_idx < _draw_batches.size(); ++batch_idx)
+    {
+        const DrawBatch& batch = _draw_batches[batch_idx];
+        const Mesh* mesh = _sorted_draw_items.meshes[batch.items_begin];
+        const MeshLOD lod = mesh->get_lod(get_sort_key_lod(_sorted_draw_items.keys[batch.items_begin]));
+
+        // Non indexed batches are always drawn directly
+        VkDrawIndexedIndirectCommand& command = commands[batch_idx];
+        command.indexCount    = mesh->get_index_buffer() ? lod.index_count : 0;
+        command.instanceCount = batch.items_end - batch.items_begin;
+        command.firstIndex    = lod.first_index;
+        command.vertexOffset  = mesh->get_range().vertex_offset;
+        command.firstInstance = batch.first_instance;
+    }
+
+    _device_context->flush_buffer_memory(*frame_res.indirect_buffer, 0, indirect_bytes);
 }
 
 void VulkanRenderer::_process_draw_items(void)
 {
+    REND_PROFILE_ZONE("record_draws");
     FrameData& frame_res = _frame_datas[_current_frame];
     CommandBuffer* cmd = frame_res.draw_cmd;
 
     ViewportInfo vp = { 0, 0, (float)_swapchain->get_extent().width, (float)_swapchain->get_extent().height, 0.0f, 1.0f };
-    ViewportInfo sc = vp;
     RenderArea ra = { static_cast<uint32_t>(vp.width), static_cast<uint32_t>(vp.height) };
 
+    // Ahead of recording, which binds the view sets at these constants' offsets
+    for(View& view : _views)
+    {
+        view.write_constants();
+    }
+
+    _sort_draw_items();
+    _build_draw_batches();
+
+    if(_indirect_draws)
+    {
+        _write_indirect_commands();
+    }
+
+    _record_passes.clear();
+    _record_jobs.clear();
+
+    // Split the batches into passes and per subpass chunks of draws
+    const uint32_t batches_count = static_cast<uint32_t>(_draw_batches.size());
+    uint32_t run_begin = 0;
+
+    while(run_begin < batches_count)
+    {
+        // Batches sharing view and render strategy are recorded into the same draw passes
+        const uint32_t first_item = _draw_batches[run_begin].items_begin;
+        const DrawSortKey pass_key = _sorted_draw_items.keys[first_item] & C_SORT_KEY_PASS_MASK;
+        uint32_t run_end = run_begin + 1;
+        while(run_end < batches_count && (_sorted_draw_items.keys[_draw_batches[run_end].items_begin] & C_SORT_KEY_PASS_MASK) == pass_key)
+        {
+            ++run_end;
+        }
+
+        auto* render_strategy = _sorted_draw_items.render_strategies[first_item];
+
+        for(auto& draw_pass : render_strategy->get_draw_passes())
+        {
+            auto* fb = frame_res.find_framebuffer(draw_pass.get_named_framebuffer());
+
+            RecordPass& record_pass = _record_passes.emplace_back();
+            record_pass.draw_pass = &draw_pass;
+            record_pass.per_pass_data = _create_per_pass_data(*fb, draw_pass.get_colour_clear(), draw_pass.get_depth_stencil_clear(), ra);
+            record_pass.first_job = static_cast<uint32_t>(_record_jobs.size());
+
+            for(uint32_t subpass_idx = 0; subpass_idx < draw_pass.get_subpasses().size(); ++subpass_idx)
+            {
+                for(uint32_t chunk_begin = run_begin; chunk_begin < run_end; chunk_begin += _DRAWS_PER_RECORD_JOB)
+                {
+                    RecordJob& job = _record_jobs.emplace_back();
+                    job.pass_idx = static_cast<uint32_t>(_record_passes.size() - 1);
+                    job.subpass_idx = subpass_idx;
+                    job.batches_begin = chunk_begin;
+                    job.batches_end = std::min(chunk_begin + _DRAWS_PER_RECORD_JOB, run_end);
+                }
+            }
+
+            record_pass.jobs_count = static_cast<uint32_t>(_record_jobs.size()) - record_pass.first_job;
+        }
+
+        run_begin = run_end;
+    }
+
+    // Record every chunk into its own secondary command buffer
+    _job_system->parallel_for(
+        static_cast<uint32_t>(_record_jobs.size()),
+        [this](uint32_t job_idx, uint32_t thread_idx)
+        {
+            _record_draw_job(job_idx, thread_idx);
+        });
+
+    // Stitch the secondaries into the primary in sorted order
+    for(auto& record_pass : _record_passes)
+    {
+        auto& draw_pass = *record_pass.draw_pass;
+        draw_pass.begin(*cmd, record_pass.per_pass_data, SubPassContents::SECONDARY_COMMAND_BUFFERS);
+
+        uint32_t current_subpass = 0;
+        for(uint32_t job_idx = record_pass.first_job; job_idx < record_pass.first_job + record_pass.jobs_count; ++job_idx)
+        {
+            RecordJob& job = _record_jobs[job_idx];
+
+            if(job.subpass_idx != current_subpass)
+            {
+                cmd->execute_commands(_record_execute_list);
+                _record_execute_list.clear();
+
+                draw_pass.next_subpass(*cmd, SubPassContents::SECONDARY_COMMAND_BUFFERS);
+                current_subpass = job.subpass_idx;
+            }
+
+            _record_execute_list.push_back(job.command_buffer);
+        }
+
+        if(!_record_execute_list.empty())
+        {
+            cmd->execute_commands(_record_execute_list);
+            _record_execute_list.clear();
+        }
+
+        draw_pass.end(*cmd);
+    }
+
+    for(auto* draw_items : _draw_item_lists)
+    {
+        draw_items->clear();
+    }
+}
+
+void VulkanRenderer::_record_draw_job(uint32_t job_idx, uint32_t thread_idx)
+{
+    REND_PROFILE_ZONE("record_draw_job");
+    RecordJob& job = _record_jobs[job_idx];
+    RecordPass& record_pass = _record_passes[job.pass_idx];
+    SubPass& subpass = record_pass.draw_pass->get_subpasses()[job.subpass_idx];
+
+    auto* command_pool = _record_command_pools[_current_frame][thread_idx];
+    auto* cmd = command_pool->acquire_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    // The pass's pipeline statistics query is active in the primary while this executes
+    const VkQueryPipelineStatisticFlags pipeline_statistics = _pass_queries[_current_frame] ? _pass_queries[_current_frame]->pipeline_statistics() : 0;
+    cmd->begin(record_pass.draw_pass->get_render_pass(), subpass.get_index(), record_pass.per_pass_data.framebuffer, pipeline_statistics);
+
+    // Secondary command buffers inherit no state from the primary
+    ViewportInfo vp = { 0, 0, (float)record_pass.per_pass_data.render_area.w, (float)record_pass.per_pass_data.render_area.h, 0.0f, 1.0f };
+    ViewportInfo sc = vp;
+
     cmd->set_viewport({vp});
     cmd->set_scissor({sc});
+    subpass.begin(*cmd);
+
+    _record_draw_batches(*cmd, subpass, job.batches_begin, job.batches_end);
+
+    cmd->end();
+
+    job.command_buffer = cmd;
+}
+
+void VulkanRenderer::_record_draw_batches(CommandBuffer& command_buffer, SubPass& subpass, uint32_t batches_begin, uint32_t batches_end)
+{
+    auto& ss = subpass.get_pipeline().get_shader_set();
+    auto& pl = ss.get_pipeline_layout();
+
+    // Shaders without an instance data set still take their per draw data as push constants
+    const bool instanced = ss.has_descriptor_set_layout(DescriptorFrequency::DRAW);
 
-    auto sorted_items = _sort_draw_items();
+    const DrawItemList& items = _sorted_draw_items;
 
-    DescriptorSet* current_view_set{ nullptr };
-    DescriptorSet* current_material_set{ nullptr };
+    const DescriptorSet* current_view_set{ nullptr };
+    const DescriptorSet* current_material_set{ nullptr };
+    const GPUBuffer* current_vertex_buffer{ nullptr };
+    const GPUBuffer* current_index_buffer{ nullptr };
 
     std::vector<const DescriptorSet*> to_bind;
     to_bind.reserve(2);
 
-    for(auto& view_it : sorted_items)
+    if(instanced)
     {
-        auto* view = view_it.first;
+        command_buffer.bind_descriptor_sets(PipelineBindPoint::GRAPHICS, pl, { _frame_datas[_current_frame].instance_set });
+    }
+
+    for(uint32_t batch_idx = batches_begin; batch_idx < batches_end; ++batch_idx)
+    {
+        const DrawBatch& batch = _draw_batches[batch_idx];
+        const uint32_t first_item = batch.items_begin;
+
+        // gl_InstanceIndex only lands on each item's data when the shader's struct is laid out at the batch's stride
+        assert((!instanced || batch.instance_stride == ss.get_instance_data_stride()) && "Per draw data does not match the shader's instance data stride");
 
-        if(auto* view_descriptor_set = &view->get_descriptor_set(); view_descriptor_set != current_view_set)
+        if(auto* view_set = &items.views[first_item]->get_descriptor_set(); view_set != current_view_set)
         {
-            current_view_set = view_descriptor_set;
+            current_view_set = view_set;
             to_bind.push_back(current_view_set);
         }
 
-        for(auto& render_strategy_it : view_it.second)
+        if(auto* material_set = &items.materials[first_item]->get_descriptor_set(); material_set != current_material_set)
         {
-            auto* render_strategy = render_strategy_it.first;
+            current_material_set = material_set;
+            to_bind.push_back(current_material_set);
+        }
 
-            for(auto& draw_pass : render_strategy->get_draw_passes())
-            {
-                auto* fb = frame_res.find_framebuffer(draw_pass.get_named_framebuffer());
-                PerPassData ppd = _create_per_pass_data(*fb, draw_pass.get_colour_clear(), draw_pass.get_depth_stencil_clear(), ra);
+        if(to_bind.size() > 0)
+        {
+            command_buffer.bind_descriptor_sets(PipelineBindPoint::GRAPHICS, pl, to_bind);
+            to_bind.clear();
+        }
 
-                draw_pass.begin(*cmd, ppd);
+        Mesh* mesh = items.meshes[first_item];
+        GPUBuffer* vertex_buffer = mesh->get_vertex_buffer();
+        GPUBuffer* index_buffer = mesh->get_index_buffer();
+        const MeshRange& range = mesh->get_range();
+        const MeshLOD lod = mesh->get_lod(get_sort_key_lod(items.keys[first_item]));
 
-                for(auto& sp : draw_pass.get_subpasses())
+        // Meshes packed into the same buffers share one binding
+        if(vertex_buffer != current_vertex_buffer)
+        {
+            current_vertex_buffer = vertex_buffer;
+            command_buffer.bind_vertex_buffer(*vertex_buffer);
+        }
+
+        if(index_buffer && index_buffer != current_index_buffer)
+        {
+            current_index_buffer = index_buffer;
+            command_buffer.bind_index_buffer(*index_buffer);
+        }
+
+        if(instanced && _indirect_draws && index_buffer)
+        {
+            // Extend the draw over following batches that need no state change in between. Sorted keys put a
+            // material's meshes next to each other, so meshes packed into shared buffers draw in one call.
+            uint32_t draw_end = batch_idx + 1;
+            while(draw_end < batches_end)
+            {
+                const uint32_t next_item = _draw_batches[draw_end].items_begin;
+                if(&items.views[next_item]->get_descriptor_set() != current_view_set ||
+                   &items.materials[next_item]->get_descriptor_set() != current_material_set ||
+                   items.meshes[next_item]->get_vertex_buffer() != vertex_buffer ||
+                   items.meshes[next_item]->get_index_buffer() != index_buffer)
                 {
-                    auto& ss = sp.get_pipeline().get_shader_set();
-                    auto& pl = ss.get_pipeline_layout();
-
-                    // Draw all items
-                    for(auto di_p : render_strategy_it.second)
-                    {
-                        Material* mat = di_p->material;
-                        if(&mat->get_descriptor_set() != current_material_set)
-                        {
-                            // New material, bind descriptor set
-                            current_material_set = &mat->get_descriptor_set();
-                            to_bind.push_back(current_material_set);
-                        }
-
-                        if(to_bind.size() > 0)
-                        {
-                            cmd->bind_descriptor_sets(PipelineBindPoint::GRAPHICS, pl, to_bind);
-                            to_bind.clear();
-                        }
-
-                        cmd->push_constant(pl, di_p->per_draw_data.stages, 0, di_p->per_draw_data.bytes, di_p->per_draw_data.data);
-
-                        Mesh* mesh = di_p->mesh;
-                        GPUBuffer* vertex_buffer = mesh->get_vertex_buffer();
-                        GPUBuffer* index_buffer = mesh->get_index_buffer();
-
-                        cmd->bind_vertex_buffer(*vertex_buffer);
-
-                        if(index_buffer)
-                        {
-                            cmd->bind_index_buffer(*index_buffer);
-                            cmd->draw_indexed(index_buffer->elements_count(), 1, 0, 0, 0);
-                        }
-                        else
-                        {
-                            cmd->draw(vertex_buffer->elements_count(), 1, 0, 0);
-                        }
-                    }
-
-                    draw_pass.next_subpass(*cmd);
+                    break;
                 }
 
-                draw_pass.end(*cmd);
+                ++draw_end;
             }
+
+            command_buffer.draw_indexed_indirect(
+                *_frame_datas[_current_frame].indirect_buffer,
+                batch_idx * sizeof(VkDrawIndexedIndirectCommand),
+                draw_end - batch_idx,
+                sizeof(VkDrawIndexedIndirectCommand));
+
+            batch_idx = draw_end - 1;
+            continue;
         }
+
+        if(instanced)
+        {
+            const uint32_t instance_count = batch.items_end - batch.items_begin;
+
+            if(index_buffer)
+            {
+                command_buffer.draw_indexed(lod.index_count, instance_count, lod.first_index, range.vertex_offset, batch.first_instance);
+            }
+            else
+            {
+                command_buffer.draw(range.vertex_count, instance_count, range.vertex_offset, batch.first_instance);
+            }
+
+            continue;
+        }
+
+        for(uint32_t item_idx = batch.items_begin; item_idx < batch.items_end; ++item_idx)
+        {
+            const PerDrawData& per_draw_data = items.per_draw_datas[item_idx];
+            command_buffer.push_constant(pl, per_draw_data.stages, 0, per_draw_data.bytes, per_draw_data.data);
+
+            if(index_buffer)
+            {
+                command_buffer.draw_indexed(lod.index_count, 1, lod.first_index, range.vertex_offset, 0);
+            }
+            else
+            {
+                command_buffer.draw(range.vertex_count, 1, range.vertex_offset, 0);
+            }
+        }
+    }
+}
+
+void VulkanRenderer::_resize_instance_buffer(FrameData& frame, size_t bytes)
+{
+    frame.instance_buffer = _grow_buffer(frame.instance_buffer, bytes, BufferUsage::STORAGE_BUFFER);
+
+    frame.instance_set->bind_resource({ 0, DescriptorType::STORAGE_BUFFER, frame.instance_buffer });
+    frame.instance_set->write_bindings();
+}
+
+GPUBuffer* VulkanRenderer::_grow_buffer(GPUBuffer* buffer, size_t bytes, BufferUsage usage)
+{
+    // Only called once this frame's previous submission has completed, so the old buffer is free to go
+    const std::string name = buffer->name();
+    size_t new_bytes = buffer->bytes();
+    while(new_bytes < bytes)
+    {
+        new_bytes <<= 1;
     }
 
-    _draw_items.clear();
+    destroy_buffer(buffer);
+    return create_buffer(name, { static_cast<uint32_t>(new_bytes), 1, usage });
 }
 
 GPUBuffer* VulkanRenderer::create_buffer(const std::string& name, const BufferInfo& info)
@@ -656,6 +1624,11 @@ GPUBuffer* VulkanRenderer::create_buffer(const std::string& name, const BufferIn
         memory_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     }
 
+    return _create_buffer(name, info, memory_flags);
+}
+
+GPUBuffer* VulkanRenderer::_create_buffer(const std::string& name, const BufferInfo& info, VkMemoryPropertyFlags memory_flags)
+{
     VulkanBufferInfo vk_buffer_info = _device_context->create_buffer(info, memory_flags);
     auto rend_handle = _buffers.allocate(name, info, vk_buffer_info);
     auto* rend_buffer = _buffers.get(rend_handle);
@@ -915,36 +1888,15 @@ PerPassData VulkanRenderer::_create_per_pass_data(const Framebuffer& fb, const C
     return ppd;
 }
 
-VulkanBuffer* VulkanRenderer::_create_staging_buffer(void)
-{
-    static int _staging_buffers_creation_count = 0;
-    const size_t STAGING_BUFFER_BYTES = 32 * 1080 * 1080;
-    static const BufferInfo STAGING_BUFFER_INFO{ 1, STAGING_BUFFER_BYTES, BufferUsage::TRANSFER_SRC };
-
-    VulkanBufferInfo vk_info = _device_context->create_buffer(STAGING_BUFFER_INFO, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-
-    auto buffer_handle = _staging_buffers.acquire();
-    auto* buffer = _staging_buffers.get(buffer_handle);
-    buffer = new(buffer) VulkanBuffer("staging buffer " + std::to_string(++_staging_buffers_creation_count), STAGING_BUFFER_INFO, vk_info);
-    buffer->_rend_handle = buffer_handle;
-
-    return buffer;
-}
-
-void VulkanRenderer::_destroy_staging_buffer(VulkanBuffer* buffer)
-{
-    auto& vk_buffer_info = buffer->vk_buffer_info();
-    _device_context->destroy_buffer(vk_buffer_info);
-
-    auto handle = buffer->_rend_handle;
-    _staging_buffers.release(handle);
-}
-
 void VulkanRenderer::destroy_buffer(GPUBuffer* buffer)
 {
     auto* vulkan_buffer = static_cast<VulkanBuffer*>(buffer);
     auto& buffer_info = vulkan_buffer->vk_buffer_info();
     auto rend_handle = vulkan_buffer->rend_handle();
+
+    // The rest of an upload split over frames would read freed data
+    std::erase_if(_pending_uploads, [buffer](const PendingUpload& upload) { return upload.buffer == buffer; });
+
     _device_context->destroy_buffer(buffer_info);
     _buffers.deallocate(rend_handle);
 }
@@ -1017,6 +1969,7 @@ void VulkanRenderer::destroy_texture(GPUTexture* texture)
     }
 
     auto rend_handle = vulkan_texture->rend_handle();
+    std::erase_if(_pending_uploads, [texture](const PendingUpload& upload) { return upload.texture == texture; });
     _device_context->destroy_texture(vk_image_info);
     _textures.deallocate(rend_handle);
 }
@@ -1048,7 +2001,7 @@ void VulkanRenderer::_resize(void)
     //}
 
     // Resize the frame resources
-    for(uint32_t fidx = 0; fidx < _FRAMES_IN_FLIGHT; ++fidx)
+    for(uint32_t fidx = 0; fidx < _frames_in_flight; ++fidx)
     {
         auto& frame = _frame_datas[fidx];
         std::vector<GPUTexture*> render_targets;
@@ -0,0 +1,247 @@
+#include "api/vulkan/vulkan_staging_ring.h"
+
+#include "api/vulkan/vulkan_buffer.h"
+#include "api/vulkan/vulkan_device_context.h"
+#include "core/logging/log_defs.h"
+#include "core/logging/log_manager.h"
+#include "core/rend_utils.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+#include <string>
+
+using namespace rend;
+
+namespace
+{
+    // Grown buffers are rounded to this so one large upload does not leave an odd sized ring behind
+    const size_t C_CAPACITY_GRANULARITY{ 1024 * 1024 };
+}
+
+VulkanStagingRing::VulkanStagingRing(VulkanDeviceContext& device_context, size_t capacity_bytes, size_t capacity_bytes_max)
+    :
+        _device_context(device_context)
+{
+    // Copy offsets are 32 bit
+    _capacity_max = std::min<size_t>(std::max(capacity_bytes, capacity_bytes_max), std::numeric_limits<uint32_t>::max());
+
+    _buffer = _create_buffer(std::min(capacity_bytes, _capacity_max));
+    assert(_buffer != nullptr && "Failed to create the staging ring");
+
+    _capacity = _buffer->bytes();
+    _mapped = static_cast<char*>(_buffer->mapped());
+
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "STAGING RING | Created staging ring with params: { bytes: " + std::to_string(_capacity) + ", max bytes: " + std::to_string(_capacity_max) + " }");
+}
+
+VulkanStagingRing::~VulkanStagingRing(void)
+{
+    for(const OldBuffer& old_buffer : _old_buffers)
+    {
+        _destroy_buffer(old_buffer.buffer);
+    }
+
+    _destroy_buffer(_buffer);
+}
+
+StagingAllocation VulkanStagingRing::allocate(size_t bytes, size_t alignment, size_t unit_bytes)
+{
+    assert(bytes > 0 && unit_bytes > 0);
+
+    // A unit past the maximum could never be staged, so the ring may grow past the maximum to fit it
+    if(unit_bytes > _capacity_max && unit_bytes <= std::numeric_limits<uint32_t>::max())
+    {
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "STAGING RING | Raised max bytes from " + std::to_string(_capacity_max) + " to fit a " + std::to_string(unit_bytes) + " byte unit");
+        _capacity_max = unit_bytes;
+    }
+
+    // Nothing is in flight, so start again from the beginning rather than split around the end
+    if(_head == _tail)
+    {
+        _head = 0;
+        _tail = 0;
+        _retired_head = 0;
+    }
+
+    size_t offset{ 0 };
+    size_t free_bytes = _find_space(bytes, alignment, offset);
+
+    if(free_bytes < bytes && _capacity < _capacity_max)
+    {
+        _grow(bytes_used() + bytes);
+        free_bytes = _find_space(bytes, alignment, offset);
+    }
+
+    const size_t taken = free_bytes >= bytes ? bytes : free_bytes - free_bytes % unit_bytes;
+    if(taken == 0)
+    {
+        return {};
+    }
+
+    // Wrapping skips whatever was left at the end of the buffer
+    const size_t head_offset = static_cast<size_t>(_head % _capacity);
+    _head += offset >= head_offset ? offset - head_offset : _capacity - head_offset + offset;
+    _head += taken;
+
+    return { _mapped + offset, _buffer, static_cast<uint32_t>(offset), static_cast<uint32_t>(taken) };
+}
+
+void VulkanStagingRing::retire(uint64_t upload_value)
+{
+    for(OldBuffer& old_buffer : _old_buffers)
+    {
+        if(!old_buffer.retired)
+        {
+            old_buffer.upload_value = upload_value;
+            old_buffer.retired = true;
+        }
+    }
+
+    if(_head == _retired_head)
+    {
+        return;
+    }
+
+    _retirements.push_back({ upload_value, _head });
+    _retired_head = _head;
+}
+
+void VulkanStagingRing::release(uint64_t completed_value)
+{
+    // Uploads complete in submission order, so retirements do too
+    size_t released = 0;
+    while(released < _retirements.size() && _retirements[released].upload_value <= completed_value)
+    {
+        _tail = _retirements[released].head;
+        ++released;
+    }
+
+    _retirements.erase(_retirements.begin(), _retirements.begin() + released);
+
+    size_t kept = 0;
+    for(const OldBuffer& old_buffer : _old_buffers)
+    {
+        if(old_buffer.retired && old_buffer.upload_value <= completed_value)
+        {
+            _destroy_buffer(old_buffer.buffer);
+        }
+        else
+        {
+            _old_buffers[kept++] = old_buffer;
+        }
+    }
+
+    _old_buffers.resize(kept);
+}
+
+bool VulkanStagingRing::fits(size_t unit_bytes) const
+{
+    return unit_bytes <= _capacity_max;
+}
+
+size_t VulkanStagingRing::capacity(void) const
+{
+    return _capacity;
+}
+
+size_t VulkanStagingRing::bytes_used(void) const
+{
+    return static_cast<size_t>(_head - _tail);
+}
+
+size_t VulkanStagingRing::_find_space(size_t bytes, size_t alignment, size_t& offset) const
+{
+    const size_t free_bytes  = _capacity - bytes_used();
+    const size_t head_offset = static_cast<size_t>(_head % _capacity);
+
+    // From the head to the end of the buffer
+    const size_t end_offset = align_up(head_offset, alignment);
+    size_t end_bytes = 0;
+    if(end_offset < _capacity && end_offset - head_offset < free_bytes)
+    {
+        end_bytes = std::min(_capacity - end_offset, free_bytes - (end_offset - head_offset));
+    }
+
+    // From the start of the buffer to the tail, when the tail is not ahead of the head
+    const size_t skipped_bytes = _capacity - head_offset;
+    const size_t start_bytes = free_bytes > skipped_bytes ? free_bytes - skipped_bytes : 0;
+
+    if(end_bytes >= bytes || end_bytes >= start_bytes)
+    {
+        offset = end_offset;
+        return end_bytes;
+    }
+
+    offset = 0;
+    return start_bytes;
+}
+
+VulkanBuffer* VulkanStagingRing::_create_buffer(size_t bytes)
+{
+    const BufferInfo info =
+    {
+        .element_count = 1,
+        .element_size  = bytes,
+        .usage         = BufferUsage::TRANSFER_SRC
+    };
+
+    // Coherent, so staged data needs no flush before the copy reads it
+    const VulkanBufferInfo vk_buffer_info = _device_context.create_buffer(info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if(vk_buffer_info.buffer == VK_NULL_HANDLE)
+    {
+        return nullptr;
+    }
+
+    const std::string name = "staging ring " + std::to_string(++_buffers_created);
+
+#if DEBUG
+    _device_context.set_debug_name(name, VK_OBJECT_TYPE_BUFFER, (uint64_t)vk_buffer_info.buffer);
+#endif
+
+    return new VulkanBuffer(name, info, vk_buffer_info);
+}
+
+void VulkanStagingRing::_destroy_buffer(VulkanBuffer* buffer)
+{
+    _device_context.destroy_buffer(buffer->vk_buffer_info());
+    delete buffer;
+}
+
+void VulkanStagingRing::_grow(size_t bytes)
+{
+    const size_t capacity = std::min(_capacity_max, std::max(_capacity * 2, align_up(bytes, C_CAPACITY_GRANULARITY)));
+
+    VulkanBuffer* buffer = _create_buffer(capacity);
+    if(buffer == nullptr)
+    {
+        // Make do with the current buffer rather than try again every upload
+        core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "STAGING RING | Failed to grow to " + std::to_string(capacity) + " bytes, staying at " + std::to_string(_capacity));
+        _capacity_max = _capacity;
+        return;
+    }
+
+    if(_head == _tail)
+    {
+        _destroy_buffer(_buffer);
+    }
+    else if(_head == _retired_head)
+    {
+        _old_buffers.push_back({ _buffer, _retirements.back().upload_value, true });
+    }
+    else
+    {
+        _old_buffers.push_back({ _buffer, 0, false });
+    }
+
+    // The old buffer's retirements are covered by its own, the new one starts empty
+    _buffer   = buffer;
+    _capacity = buffer->bytes();
+    _mapped   = static_cast<char*>(_buffer->mapped());
+    _head = 0;
+    _tail = 0;
+    _retired_head = 0;
+    _retirements.clear();
+
+    core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "STAGING RING | Grew to " + std::to_string(_capacity) + " bytes");
+}
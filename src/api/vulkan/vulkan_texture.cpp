@@ -1,5 +1,8 @@
 #include "api/vulkan/vulkan_texture.h"
 
+#include <algorithm>
+#include <cassert>
+
 using namespace rend;
 
 VulkanTexture::VulkanTexture(const std::string& name, const TextureInfo& info, const VulkanImageInfo& vk_image_info)
@@ -7,6 +10,10 @@ VulkanTexture::VulkanTexture(const std::string& name, const TextureInfo& info, c
         GPUTexture(name, info),
         _vk_image_info(vk_image_info)
 {
+    // Some textures, e.g. swapchain images, leave mips or layers at 0 to mean 1
+    _mips_count   = std::max(mips(), 1u);
+    _layers_count = std::max(layers(), 1u);
+    _subresource_states.resize(static_cast<size_t>(_mips_count) * _layers_count);
 }
 
 const VulkanImageInfo& VulkanTexture::vk_image_info(void) const
@@ -14,3 +21,24 @@ const VulkanImageInfo& VulkanTexture::vk_image_info(void) const
     return _vk_image_info;
 }
 
+const VulkanSubresourceState& VulkanTexture::get_subresource_state(uint32_t mip, uint32_t layer) const
+{
+    assert(mip < _mips_count && layer < _layers_count);
+    return _subresource_states[static_cast<size_t>(layer) * _mips_count + mip];
+}
+
+void VulkanTexture::set_subresource_state(uint32_t mip, uint32_t layer, const VulkanSubresourceState& state)
+{
+    assert(mip < _mips_count && layer < _layers_count);
+    _subresource_states[static_cast<size_t>(layer) * _mips_count + mip] = state;
+}
+
+uint32_t VulkanTexture::subresource_mips(void) const
+{
+    return _mips_count;
+}
+
+uint32_t VulkanTexture::subresource_layers(void) const
+{
+    return _layers_count;
+}
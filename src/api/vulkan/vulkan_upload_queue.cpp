@@ -0,0 +1,236 @@
+#include "api/vulkan/vulkan_upload_queue.h"
+
+#include "api/vulkan/logical_device.h"
+#include "api/vulkan/vulkan_buffer.h"
+#include "api/vulkan/vulkan_command_buffer.h"
+#include "api/vulkan/vulkan_command_pool.h"
+#include "api/vulkan/vulkan_device_context.h"
+#include "api/vulkan/vulkan_helper_funcs.h"
+#include "api/vulkan/vulkan_texture.h"
+#include "core/gpu_buffer.h"
+#include "core/gpu_texture.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace rend;
+
+VulkanUploadQueue::VulkanUploadQueue(VulkanDeviceContext& device_context, uint32_t frames_in_flight)
+    :
+        _device_context(device_context)
+{
+    _timeline = new TimelineSemaphore("upload timeline", _timeline_value, _device_context);
+
+    _transfer_family_index = _device_context.get_device()->get_queue_family(QueueType::TRANSFER)->get_index();
+    _graphics_family_index = _device_context.get_device()->get_queue_family(QueueType::GRAPHICS)->get_index();
+    _image_granularity = _device_context.get_device()->get_queue_family(QueueType::TRANSFER)->get_properties().minImageTransferGranularity;
+
+    _command_pool_values.resize(frames_in_flight, 0);
+    for(uint32_t idx = 0; idx < frames_in_flight; ++idx)
+    {
+        _command_pools.push_back(new VulkanCommandPool("frame " + std::to_string(idx) + " upload command pool", _device_context, QueueType::TRANSFER));
+    }
+}
+
+VulkanUploadQueue::~VulkanUploadQueue(void)
+{
+    _timeline->wait(_timeline_value);
+
+    for(auto* command_pool : _command_pools)
+    {
+        delete command_pool;
+    }
+
+    delete _timeline;
+}
+
+void VulkanUploadQueue::start_frame(uint32_t frame_idx)
+{
+    assert(_command_buffer == nullptr && "Uploads recorded last frame were never submitted");
+
+    _frame_idx = frame_idx;
+    _timeline->wait(_command_pool_values[_frame_idx]);
+    _command_pools[_frame_idx]->reset();
+}
+
+void VulkanUploadQueue::upload(const GPUBuffer& staging_buffer, GPUBuffer& buffer, const BufferBufferCopyInfo& info)
+{
+    VulkanCommandBuffer* cmd = _get_command_buffer();
+    cmd->copy(staging_buffer, buffer, info);
+
+    _read_stages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    if(_transfer_family_index == _graphics_family_index)
+    {
+        return;
+    }
+
+    VkBufferMemoryBarrier2 barrier =
+    {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .pNext               = nullptr,
+        .srcStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT,
+        .srcAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .dstStageMask        = VK_PIPELINE_STAGE_2_NONE,
+        .dstAccessMask       = VK_ACCESS_2_NONE,
+        .srcQueueFamilyIndex = _transfer_family_index,
+        .dstQueueFamilyIndex = _graphics_family_index,
+        .buffer              = static_cast<VulkanBuffer&>(buffer).vk_buffer_info().buffer,
+        .offset              = info.dst_offset,
+        .size                = info.size_bytes
+    };
+
+    _post_copy_barriers.barrier(barrier);
+
+    barrier.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+    barrier.srcAccessMask = VK_ACCESS_2_NONE;
+    barrier.dstStageMask  = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT;
+    _acquires.barrier(barrier);
+}
+
+void VulkanUploadQueue::upload(const GPUBuffer& staging_buffer, GPUTexture& texture, const BufferImageCopyInfo& info, bool first_part, bool last_part)
+{
+    _get_command_buffer();
+
+    auto& vk_texture = static_cast<VulkanTexture&>(texture);
+    const bool transfers_ownership = _transfer_family_index != _graphics_family_index;
+
+    // The first part starts rewriting the whole image, so its old contents and owner do not matter. Later parts keep
+    // what earlier ones copied.
+    VulkanImageTransition transition =
+    {
+        .layout   = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .stages   = VK_PIPELINE_STAGE_2_COPY_BIT,
+        .accesses = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .discard  = first_part
+    };
+
+    _pre_copy_barriers.transition(vk_texture, transition);
+
+    BufferImageCopyInfo copy_info = info;
+    copy_info.image_layout = ImageLayout::TRANSFER_DST;
+    _texture_copies.push_back({ &staging_buffer, &texture, copy_info });
+
+    if(!last_part)
+    {
+        return;
+    }
+
+    // Release, changing to the layout it is sampled in. The semaphore wait makes the copy visible to the reader.
+    transition.layout   = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    transition.stages   = VK_PIPELINE_STAGE_2_NONE;
+    transition.accesses = VK_ACCESS_2_NONE;
+    transition.discard  = false;
+    if(transfers_ownership)
+    {
+        transition.src_queue_family = _transfer_family_index;
+        transition.dst_queue_family = _graphics_family_index;
+    }
+
+    _post_copy_barriers.transition(vk_texture, transition);
+    _read_stages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+    if(transfers_ownership)
+    {
+        const auto& image_info = vk_texture.vk_image_info();
+        VkImageMemoryBarrier2 acquire =
+        {
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .pNext               = nullptr,
+            .srcStageMask        = VK_PIPELINE_STAGE_2_NONE,
+            .srcAccessMask       = VK_ACCESS_2_NONE,
+            .dstStageMask        = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            .dstAccessMask       = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+            .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .srcQueueFamilyIndex = _transfer_family_index,
+            .dstQueueFamilyIndex = _graphics_family_index,
+            .image               = image_info.image,
+            .subresourceRange    =
+            {
+                .aspectMask     = vulkan_helpers::find_image_aspects(vulkan_helpers::convert_format(texture.format())),
+                .baseMipLevel   = 0,
+                .levelCount     = vk_texture.subresource_mips(),
+                .baseArrayLayer = 0,
+                .layerCount     = vk_texture.subresource_layers()
+            }
+        };
+
+        _acquires.barrier(acquire);
+    }
+}
+
+TimelinePoint VulkanUploadQueue::submit(VulkanCommandBuffer& acquire_cmd)
+{
+    assert(has_uploads());
+
+    _pre_copy_barriers.flush(*_command_buffer);
+    for(const TextureCopy& copy : _texture_copies)
+    {
+        _command_buffer->copy(*copy.staging_buffer, *copy.texture, copy.info);
+    }
+
+    _texture_copies.clear();
+    _post_copy_barriers.flush(*_command_buffer);
+
+    _command_buffer->end();
+    _stats = _command_buffer->get_stats();
+
+    TimelinePoint signal{ _timeline, ++_timeline_value };
+    _device_context.queue_submit(*_command_buffer, QueueType::TRANSFER, {}, {}, {}, { signal }, nullptr);
+    _command_pool_values[_frame_idx] = _timeline_value;
+    _command_buffer = nullptr;
+
+    // Acquires run once acquire_cmd's submit has waited on the upload
+    _acquires.flush(acquire_cmd);
+
+    TimelinePoint wait{ _timeline, _timeline_value, _read_stages };
+    _read_stages = 0;
+
+    return wait;
+}
+
+uint32_t VulkanUploadQueue::texture_split_rows(const GPUTexture& texture) const
+{
+    // Copies of any size start anywhere
+    if(_image_granularity.width == 1 && _image_granularity.height == 1 && _image_granularity.depth == 1)
+    {
+        return 1;
+    }
+
+    // Otherwise only whole subresources are sure to be copyable, whatever the granularity, so parts are whole layers.
+    // Depth slices of a 3D texture are as good when the granularity allows copying one at a time.
+    const uint32_t depth = std::max(texture.depth(), 1u);
+    if(depth == 1 || _image_granularity.depth == 1)
+    {
+        return texture.height();
+    }
+
+    return texture.height() * depth;
+}
+
+bool VulkanUploadQueue::has_uploads(void) const
+{
+    return _command_buffer != nullptr;
+}
+
+uint64_t VulkanUploadQueue::get_completed_value(void) const
+{
+    return _timeline->get_value();
+}
+
+const CommandBufferStats& VulkanUploadQueue::get_stats(void) const
+{
+    return _stats;
+}
+
+VulkanCommandBuffer* VulkanUploadQueue::_get_command_buffer(void)
+{
+    if(_command_buffer == nullptr)
+    {
+        _command_buffer = _command_pools[_frame_idx]->acquire_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        _command_buffer->begin();
+    }
+
+    return _command_buffer;
+}
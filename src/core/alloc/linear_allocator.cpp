@@ -0,0 +1,114 @@
+#include "core/alloc/linear_allocator.h"
+
+#include "core/rend_utils.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace rend;
+
+LinearAllocator::LinearAllocator(size_t capacity_bytes)
+{
+    _first = _create_block(capacity_bytes);
+    _current.store(_first, std::memory_order_relaxed);
+}
+
+LinearAllocator::~LinearAllocator(void)
+{
+    Block* block = _first;
+    while(block)
+    {
+        Block* next = block->next;
+        std::free(block->data);
+        delete block;
+        block = next;
+    }
+}
+
+void* LinearAllocator::allocate(size_t bytes)
+{
+    bytes = align_up(std::max(bytes, size_t(1)), C_CACHE_LINE_BYTES);
+
+    if(void* memory = _try_allocate(*_current.load(std::memory_order_acquire), bytes))
+    {
+        return memory;
+    }
+
+    return _allocate_slow(bytes);
+}
+
+void LinearAllocator::reset(void)
+{
+    // Replace a chain of blocks with one block big enough for all of them, so the next frame does not need to grow
+    if(_first->next)
+    {
+        size_t capacity = 0;
+        Block* block = _first;
+        while(block)
+        {
+            Block* next = block->next;
+            capacity += block->capacity;
+            std::free(block->data);
+            delete block;
+            block = next;
+        }
+
+        _first = _create_block(capacity);
+    }
+
+    _first->offset.store(0, std::memory_order_relaxed);
+    _current.store(_first, std::memory_order_release);
+}
+
+size_t LinearAllocator::bytes_used(void) const
+{
+    size_t bytes = 0;
+    for(Block* block = _first; block; block = block->next)
+    {
+        bytes += std::min(block->offset.load(std::memory_order_relaxed), block->capacity);
+    }
+
+    return bytes;
+}
+
+LinearAllocator::Block* LinearAllocator::_create_block(size_t capacity_bytes)
+{
+    Block* block = new Block;
+    block->capacity = align_up(capacity_bytes, C_CACHE_LINE_BYTES);
+    block->data = static_cast<char*>(std::aligned_alloc(C_CACHE_LINE_BYTES, block->capacity));
+
+    return block;
+}
+
+void* LinearAllocator::_try_allocate(Block& block, size_t bytes)
+{
+    // Offsets only ever grow by multiples of a cache line, so every allocation starts on one.
+    // A failed attempt leaves the offset past the end, which just marks the block as full.
+    const size_t offset = block.offset.fetch_add(bytes, std::memory_order_relaxed);
+    if(offset + bytes > block.capacity)
+    {
+        return nullptr;
+    }
+
+    return block.data + offset;
+}
+
+void* LinearAllocator::_allocate_slow(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_grow_mutex);
+
+    // Another thread may have chained on a new block while this one waited
+    Block* current = _current.load(std::memory_order_acquire);
+    if(void* memory = _try_allocate(*current, bytes))
+    {
+        return memory;
+    }
+
+    Block* block = _create_block(std::max(current->capacity * 2, bytes));
+    current->next = block;
+
+    void* memory = _try_allocate(*block, bytes);
+    _current.store(block, std::memory_order_release);
+
+    return memory;
+}
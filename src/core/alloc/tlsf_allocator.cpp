@@ -0,0 +1,284 @@
+#include "core/alloc/tlsf_allocator.h"
+
+#include "core/rend_utils.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+
+using namespace rend;
+
+TLSFAllocator::TLSFAllocator(uint64_t capacity_bytes)
+    :
+        _capacity(capacity_bytes - capacity_bytes % _GRANULARITY)
+{
+    assert(_capacity > 0 && "TLSF allocator needs at least one granule");
+
+    for(auto& heads : _free_heads)
+    {
+        heads.fill(C_NO_NODE);
+    }
+
+    _insert_free(_create_node(0, _capacity));
+}
+
+TLSFAllocation TLSFAllocator::allocate(uint64_t bytes, uint64_t alignment)
+{
+    assert(std::has_single_bit(alignment) && "Alignment must be a power of two");
+
+    bytes = align_up(std::max<uint64_t>(bytes, 1), _GRANULARITY);
+    alignment = std::max(alignment, _GRANULARITY);
+
+    // Offsets are always granule aligned, so this is the most padding any free range can need
+    const uint64_t padding_max = alignment - _GRANULARITY;
+    if(bytes > _capacity || padding_max > _capacity - bytes)
+    {
+        return {};
+    }
+
+    uint32_t node = _find_free(bytes + padding_max);
+    if(node == C_NO_NODE)
+    {
+        return {};
+    }
+
+    _remove_free(node);
+
+    // Padding in front of the aligned offset goes back as a free range of its own
+    const uint64_t padding = align_up(_nodes[node].offset, alignment) - _nodes[node].offset;
+    if(padding > 0)
+    {
+        const uint32_t aligned = _split(node, padding);
+        _insert_free(node);
+        node = aligned;
+    }
+
+    if(_nodes[node].bytes > bytes)
+    {
+        _insert_free(_split(node, bytes));
+    }
+
+    _nodes[node].free = false;
+    _bytes_used += _nodes[node].bytes;
+    ++_allocations_count;
+
+    return { _nodes[node].offset, _nodes[node].bytes, node };
+}
+
+void TLSFAllocator::free(const TLSFAllocation& allocation)
+{
+    uint32_t node = allocation.node;
+    assert(node < _nodes.size() && !_nodes[node].free && "Freeing an allocation that is not live");
+
+    _bytes_used -= _nodes[node].bytes;
+    --_allocations_count;
+    _nodes[node].free = true;
+
+    const uint32_t next = _nodes[node].next_physical;
+    if(next != C_NO_NODE && _nodes[next].free)
+    {
+        _remove_free(next);
+        _merge_into_prev(next);
+    }
+
+    const uint32_t prev = _nodes[node].prev_physical;
+    if(prev != C_NO_NODE && _nodes[prev].free)
+    {
+        _remove_free(prev);
+        _merge_into_prev(node);
+        node = prev;
+    }
+
+    _insert_free(node);
+}
+
+uint64_t TLSFAllocator::capacity(void) const
+{
+    return _capacity;
+}
+
+uint64_t TLSFAllocator::bytes_used(void) const
+{
+    return _bytes_used;
+}
+
+uint32_t TLSFAllocator::allocations_count(void) const
+{
+    return _allocations_count;
+}
+
+void TLSFAllocator::_mapping(uint64_t bytes, uint32_t& fl, uint32_t& sl)
+{
+    if(bytes < (uint64_t(1) << _FL_SHIFT))
+    {
+        fl = 0;
+        sl = static_cast<uint32_t>(bytes >> (_FL_SHIFT - _SL_BITS));
+        return;
+    }
+
+    const uint32_t msb = static_cast<uint32_t>(std::bit_width(bytes)) - 1;
+    fl = msb - _FL_SHIFT + 1;
+    sl = static_cast<uint32_t>(bytes >> (msb - _SL_BITS)) ^ _SL_COUNT;
+}
+
+uint32_t TLSFAllocator::_create_node(uint64_t offset, uint64_t bytes)
+{
+    uint32_t node{ C_NO_NODE };
+
+    if(_unused_nodes.empty())
+    {
+        node = static_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+    }
+    else
+    {
+        node = _unused_nodes.back();
+        _unused_nodes.pop_back();
+        _nodes[node] = Node{};
+    }
+
+    _nodes[node].offset = offset;
+    _nodes[node].bytes = bytes;
+
+    return node;
+}
+
+void TLSFAllocator::_destroy_node(uint32_t node)
+{
+    _unused_nodes.push_back(node);
+}
+
+uint32_t TLSFAllocator::_find_free(uint64_t bytes)
+{
+    // Round up to the next size class, so any range in the bin found is big enough
+    uint64_t class_bytes = bytes;
+    if(bytes >= (uint64_t(1) << _FL_SHIFT))
+    {
+        class_bytes += (uint64_t(1) << (std::bit_width(bytes) - 1 - _SL_BITS)) - 1;
+    }
+
+    uint32_t fl{ 0 };
+    uint32_t sl{ 0 };
+    _mapping(class_bytes, fl, sl);
+
+    uint32_t sl_map = fl < _FL_COUNT ? _sl_bitmaps[fl] & (~0u << sl) : 0;
+    if(sl_map == 0)
+    {
+        const uint64_t fl_map = fl + 1 < 64 ? _fl_bitmap & (~0ull << (fl + 1)) : 0;
+        if(fl_map != 0)
+        {
+            fl = static_cast<uint32_t>(std::countr_zero(fl_map));
+            sl_map = _sl_bitmaps[fl];
+        }
+    }
+
+    if(sl_map != 0)
+    {
+        return _free_heads[fl][static_cast<uint32_t>(std::countr_zero(sl_map))];
+    }
+
+    // Nothing in a bigger class, a range in the request's own class may still fit
+    _mapping(bytes, fl, sl);
+
+    for(uint32_t node = _free_heads[fl][sl]; node != C_NO_NODE; node = _nodes[node].next_free)
+    {
+        if(_nodes[node].bytes >= bytes)
+        {
+            return node;
+        }
+    }
+
+    return C_NO_NODE;
+}
+
+void TLSFAllocator::_insert_free(uint32_t node)
+{
+    uint32_t fl{ 0 };
+    uint32_t sl{ 0 };
+    _mapping(_nodes[node].bytes, fl, sl);
+
+    const uint32_t head = _free_heads[fl][sl];
+    _nodes[node].free = true;
+    _nodes[node].prev_free = C_NO_NODE;
+    _nodes[node].next_free = head;
+
+    if(head != C_NO_NODE)
+    {
+        _nodes[head].prev_free = node;
+    }
+
+    _free_heads[fl][sl] = node;
+    _sl_bitmaps[fl] |= 1u << sl;
+    _fl_bitmap |= 1ull << fl;
+}
+
+void TLSFAllocator::_remove_free(uint32_t node)
+{
+    uint32_t fl{ 0 };
+    uint32_t sl{ 0 };
+    _mapping(_nodes[node].bytes, fl, sl);
+
+    const uint32_t prev = _nodes[node].prev_free;
+    const uint32_t next = _nodes[node].next_free;
+
+    if(prev != C_NO_NODE)
+    {
+        _nodes[prev].next_free = next;
+    }
+    else
+    {
+        _free_heads[fl][sl] = next;
+    }
+
+    if(next != C_NO_NODE)
+    {
+        _nodes[next].prev_free = prev;
+    }
+
+    if(_free_heads[fl][sl] == C_NO_NODE)
+    {
+        _sl_bitmaps[fl] &= ~(1u << sl);
+        if(_sl_bitmaps[fl] == 0)
+        {
+            _fl_bitmap &= ~(1ull << fl);
+        }
+    }
+
+    _nodes[node].prev_free = C_NO_NODE;
+    _nodes[node].next_free = C_NO_NODE;
+}
+
+uint32_t TLSFAllocator::_split(uint32_t node, uint64_t bytes)
+{
+    // Returns the new node holding everything past the first bytes of node
+    const uint32_t back = _create_node(_nodes[node].offset + bytes, _nodes[node].bytes - bytes);
+
+    _nodes[back].prev_physical = node;
+    _nodes[back].next_physical = _nodes[node].next_physical;
+
+    if(_nodes[back].next_physical != C_NO_NODE)
+    {
+        _nodes[_nodes[back].next_physical].prev_physical = back;
+    }
+
+    _nodes[node].next_physical = back;
+    _nodes[node].bytes = bytes;
+
+    return back;
+}
+
+void TLSFAllocator::_merge_into_prev(uint32_t node)
+{
+    const uint32_t prev = _nodes[node].prev_physical;
+    const uint32_t next = _nodes[node].next_physical;
+
+    _nodes[prev].bytes += _nodes[node].bytes;
+    _nodes[prev].next_physical = next;
+
+    if(next != C_NO_NODE)
+    {
+        _nodes[next].prev_physical = prev;
+    }
+
+    _destroy_node(node);
+}
@@ -0,0 +1,92 @@
+#include "core/bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace rend;
+
+namespace
+{
+    const glm::vec3& vertex_position(const void* vertices, size_t stride, uint32_t idx)
+    {
+        return *reinterpret_cast<const glm::vec3*>(static_cast<const char*>(vertices) + stride * idx);
+    }
+}
+
+AABB rend::compute_aabb(const void* vertices, size_t stride, uint32_t vertex_count)
+{
+    AABB aabb{};
+    if(vertex_count == 0)
+    {
+        return aabb;
+    }
+
+    aabb.min = aabb.max = vertex_position(vertices, stride, 0);
+    for(uint32_t idx = 1; idx < vertex_count; ++idx)
+    {
+        const glm::vec3& position = vertex_position(vertices, stride, idx);
+        aabb.min = glm::min(aabb.min, position);
+        aabb.max = glm::max(aabb.max, position);
+    }
+
+    return aabb;
+}
+
+BoundingSphere rend::compute_bounding_sphere(const AABB& aabb, const void* vertices, size_t stride, uint32_t vertex_count)
+{
+    // Centred on the box, but sized to the furthest vertex rather than the box corner
+    BoundingSphere sphere{};
+    sphere.centre = (aabb.min + aabb.max) * 0.5f;
+
+    float radius_sq = 0.0f;
+    for(uint32_t idx = 0; idx < vertex_count; ++idx)
+    {
+        const glm::vec3 offset = vertex_position(vertices, stride, idx) - sphere.centre;
+        radius_sq = std::max(radius_sq, glm::dot(offset, offset));
+    }
+
+    sphere.radius = std::sqrt(radius_sq);
+
+    return sphere;
+}
+
+BoundingSphere rend::transform_bounding_sphere(const BoundingSphere& sphere, const glm::mat4& transform)
+{
+    // Non uniform scale stretches the sphere, so cover it with the largest axis scale
+    const float scale_sq = std::max({
+        glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+        glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+        glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))
+    });
+
+    BoundingSphere world_sphere{};
+    world_sphere.centre = glm::vec3(transform * glm::vec4(sphere.centre, 1.0f));
+    world_sphere.radius = sphere.radius * std::sqrt(scale_sq);
+
+    return world_sphere;
+}
+
+Frustum rend::make_frustum(const glm::mat4& view_projection)
+{
+    // Gribb-Hartmann plane extraction from the rows of the matrix
+    const glm::vec4 row_x{ view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0] };
+    const glm::vec4 row_y{ view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1] };
+    const glm::vec4 row_z{ view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2] };
+    const glm::vec4 row_w{ view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3] };
+
+    // The near plane uses z >= -w, which also holds for 0..1 depth projections, just less tightly
+    Frustum frustum{};
+    frustum.planes[0] = row_w + row_x;
+    frustum.planes[1] = row_w - row_x;
+    frustum.planes[2] = row_w + row_y;
+    frustum.planes[3] = row_w - row_y;
+    frustum.planes[4] = row_w + row_z;
+    frustum.planes[5] = row_w - row_z;
+
+    for(auto& plane : frustum.planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return frustum;
+}
@@ -2,6 +2,9 @@
 
 #include "core/descriptor_set_layout.h"
 
+#include <algorithm>
+#include <assert.h>
+
 using namespace rend;
 
 DescriptorSet::DescriptorSet(const std::string& name, const DescriptorSetLayout& layout)
@@ -23,5 +26,30 @@ const std::vector<DescriptorSetBinding>& DescriptorSet::get_bindings(void) const
 
 void DescriptorSet::bind_resource(const DescriptorSetBinding& descriptor)
 {
+    // Rebinding a slot replaces whatever was bound there
+    for(auto& binding : _bindings)
+    {
+        if(binding.slot == descriptor.slot)
+        {
+            binding = descriptor;
+            return;
+        }
+    }
+
     _bindings.push_back(descriptor);
 }
+
+void DescriptorSet::set_dynamic_offsets(const std::vector<uint32_t>& offsets)
+{
+    assert(offsets.size() == static_cast<size_t>(std::count_if(_bindings.begin(), _bindings.end(), [](const DescriptorSetBinding& binding)
+    {
+        return binding.type == DescriptorType::UNIFORM_BUFFER_DYNAMIC || binding.type == DescriptorType::STORAGE_BUFFER_DYNAMIC;
+    })) && "Need one dynamic offset per dynamic buffer binding");
+
+    _dynamic_offsets = offsets;
+}
+
+const std::vector<uint32_t>& DescriptorSet::get_dynamic_offsets(void) const
+{
+    return _dynamic_offsets;
+}
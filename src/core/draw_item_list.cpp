@@ -0,0 +1,101 @@
+#include "core/draw_item_list.h"
+
+#include "core/descriptor_set.h"
+#include "core/draw_pass.h"
+#include "core/material.h"
+#include "core/mesh.h"
+#include "core/pipeline.h"
+#include "core/render_strategy.h"
+#include "core/sub_pass.h"
+#include "core/view.h"
+
+using namespace rend;
+
+namespace
+{
+    DrawSortKey make_sort_key(const DrawItem& draw_item, RenderStrategy& render_strategy)
+    {
+        // Every pass and subpass of the strategy records each of its items, so no one pipeline describes the draw.
+        // The key carries the first subpass's pipeline. All of a strategy's items share it and the strategy field
+        // sits above it, so it never splits what the strategy field groups.
+        RendHandle pipeline_handle = REND_NULL_HANDLE;
+        auto& draw_passes = render_strategy.get_draw_passes();
+        if(!draw_passes.empty() && !draw_passes[0].get_subpasses().empty())
+        {
+            pipeline_handle = draw_passes[0].get_subpasses()[0].get_pipeline().rend_handle();
+        }
+
+        return make_draw_sort_key(
+            draw_item.view->rend_handle(),
+            render_strategy.rend_handle(),
+            pipeline_handle,
+            draw_item.material->get_descriptor_set().rend_handle(),
+            draw_item.mesh->rend_handle()
+        );
+    }
+}
+
+uint32_t DrawItemList::size(void) const
+{
+    return static_cast<uint32_t>(keys.size());
+}
+
+void DrawItemList::clear(void)
+{
+    resize(0);
+}
+
+void DrawItemList::resize(uint32_t count)
+{
+    keys.resize(count);
+    meshes.resize(count);
+    materials.resize(count);
+    views.resize(count);
+    render_strategies.resize(count);
+    transforms.resize(count);
+    per_draw_datas.resize(count);
+}
+
+uint32_t DrawItemList::push_back(const DrawItem& draw_item)
+{
+    const uint32_t idx = size();
+    resize(idx + 1);
+    set(idx, draw_item);
+
+    return idx;
+}
+
+void DrawItemList::append(std::span<const DrawItem> draw_items)
+{
+    const uint32_t first = size();
+    resize(first + static_cast<uint32_t>(draw_items.size()));
+
+    for(uint32_t i = 0; i < draw_items.size(); ++i)
+    {
+        set(first + i, draw_items[i]);
+    }
+}
+
+void DrawItemList::set(uint32_t idx, const DrawItem& draw_item)
+{
+    RenderStrategy* render_strategy = draw_item.material->get_material_info().render_strategy;
+
+    keys[idx]              = make_sort_key(draw_item, *render_strategy);
+    meshes[idx]            = draw_item.mesh;
+    materials[idx]         = draw_item.material;
+    views[idx]             = draw_item.view;
+    render_strategies[idx] = render_strategy;
+    transforms[idx]        = draw_item.transform;
+    per_draw_datas[idx]    = draw_item.per_draw_data;
+}
+
+void DrawItemList::copy(uint32_t idx, const DrawItemList& src, uint32_t src_idx)
+{
+    keys[idx]              = src.keys[src_idx];
+    meshes[idx]            = src.meshes[src_idx];
+    materials[idx]         = src.materials[src_idx];
+    views[idx]             = src.views[src_idx];
+    render_strategies[idx] = src.render_strategies[src_idx];
+    transforms[idx]        = src.transforms[src_idx];
+    per_draw_datas[idx]    = src.per_draw_datas[src_idx];
+}
@@ -1,5 +1,6 @@
 #include "core/draw_pass.h"
 
+#include "core/command_buffer.h"
 #include "core/renderer.h"
 #include "core/render_pass.h"
 #include "core/sub_pass.h"
@@ -49,6 +50,11 @@ DrawPass::~DrawPass(void)
     //}
 }
 
+const RenderPass& DrawPass::get_render_pass(void) const
+{
+    return _render_pass;
+}
+
 const std::string& DrawPass::get_named_framebuffer(void) const
 {
     return  _named_framebuffer;
@@ -80,26 +86,38 @@ std::vector<SubPass>& DrawPass::get_subpasses(void)
     return _subpasses;
 }
 
-void DrawPass::begin(CommandBuffer& command_buffer, const PerPassData& per_pass_data)
+void DrawPass::begin(CommandBuffer& command_buffer, const PerPassData& per_pass_data, SubPassContents contents)
 {
     core::logging::LogManager::write(core::logging::C_RENDERER_LOG_CHANNEL_NAME, "RENDERER | Begin draw pass (" + name() + ") with params: " + core::logging::to_string(per_pass_data));
 
     _current_subpass = 0;
-    _render_pass.begin(command_buffer, per_pass_data);
-    _subpasses[_current_subpass].begin(command_buffer);
+    command_buffer.begin_pass_query(name(), static_cast<uint32_t>(_subpasses.size()));
+    _render_pass.begin(command_buffer, per_pass_data, contents);
+    command_buffer.begin_subpass_query(_subpasses[_current_subpass].name(), contents);
+
+    if(contents == SubPassContents::INLINE)
+    {
+        _subpasses[_current_subpass].begin(command_buffer);
+    }
 }
 
 void DrawPass::end(CommandBuffer& command_buffer)
 {
     _render_pass.end(command_buffer);
+    command_buffer.end_pass_query();
 }
 
-void DrawPass::next_subpass(CommandBuffer& command_buffer)
+void DrawPass::next_subpass(CommandBuffer& command_buffer, SubPassContents contents)
 {
     if(has_next_subpass())
     {
         ++_current_subpass;
-        _render_pass.next_subpass(command_buffer);
-        _subpasses[_current_subpass].begin(command_buffer);
+        _render_pass.next_subpass(command_buffer, contents);
+        command_buffer.begin_subpass_query(_subpasses[_current_subpass].name(), contents);
+
+        if(contents == SubPassContents::INLINE)
+        {
+            _subpasses[_current_subpass].begin(command_buffer);
+        }
     }
 }
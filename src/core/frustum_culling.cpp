@@ -0,0 +1,87 @@
+#include "core/frustum_culling.h"
+
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+using namespace rend;
+
+void CullSpheres::resize(size_t count)
+{
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    radius.resize(count);
+}
+
+void rend::cull_spheres(const Frustum& frustum, const CullSpheres& spheres, uint32_t first, uint32_t count, uint8_t* visible)
+{
+    const float* xs = spheres.x.data() + first;
+    const float* ys = spheres.y.data() + first;
+    const float* zs = spheres.z.data() + first;
+    const float* rs = spheres.radius.data() + first;
+    uint8_t* out = visible + first;
+
+    uint32_t idx = 0;
+
+#if defined(__AVX__)
+    for(; idx + 8 <= count; idx += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(xs + idx);
+        const __m256 y = _mm256_loadu_ps(ys + idx);
+        const __m256 z = _mm256_loadu_ps(zs + idx);
+        const __m256 neg_radius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(rs + idx));
+
+        __m256 inside = _mm256_cmp_ps(neg_radius, neg_radius, _CMP_EQ_OQ);
+        for(const auto& plane : frustum.planes)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_set1_ps(plane.w));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(y, _mm256_set1_ps(plane.y)));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(z, _mm256_set1_ps(plane.z)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, neg_radius, _CMP_GE_OQ));
+        }
+
+        const int mask = _mm256_movemask_ps(inside);
+        for(uint32_t lane = 0; lane < 8; ++lane)
+        {
+            out[idx + lane] = (mask >> lane) & 1;
+        }
+    }
+#elif defined(__SSE__)
+    for(; idx + 4 <= count; idx += 4)
+    {
+        const __m128 x = _mm_loadu_ps(xs + idx);
+        const __m128 y = _mm_loadu_ps(ys + idx);
+        const __m128 z = _mm_loadu_ps(zs + idx);
+        const __m128 neg_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(rs + idx));
+
+        __m128 inside = _mm_cmpeq_ps(neg_radius, neg_radius);
+        for(const auto& plane : frustum.planes)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_set1_ps(plane.w));
+            distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, neg_radius));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for(uint32_t lane = 0; lane < 4; ++lane)
+        {
+            out[idx + lane] = (mask >> lane) & 1;
+        }
+    }
+#endif
+
+    // Scalar fallback, and the tail that does not fill a whole register
+    for(; idx < count; ++idx)
+    {
+        uint8_t inside = 1;
+        for(const auto& plane : frustum.planes)
+        {
+            const float distance = xs[idx] * plane.x + plane.w + ys[idx] * plane.y + zs[idx] * plane.z;
+            inside &= distance >= -rs[idx];
+        }
+
+        out[idx] = inside;
+    }
+}
@@ -0,0 +1,406 @@
+#include "core/job_system.h"
+
+#include "core/profiler.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace rend;
+
+JobSystem* JobSystem::_instance = nullptr;
+
+namespace
+{
+    constexpr uint32_t C_NO_THREAD{ 0xFFFFFFFF };
+
+    thread_local uint32_t t_thread_idx{ C_NO_THREAD };
+
+    uint32_t next_random(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+void JobSystem::initialise(uint32_t worker_count)
+{
+    if(_instance == nullptr)
+    {
+        _instance = new JobSystem(worker_count);
+    }
+}
+
+void JobSystem::uninitialise(void)
+{
+    if(_instance != nullptr)
+    {
+        delete _instance;
+        _instance = nullptr;
+    }
+}
+
+JobSystem& JobSystem::get_instance(void)
+{
+    return *_instance;
+}
+
+JobSystem::JobSystem(uint32_t worker_count)
+    :
+        _thread_datas(worker_count + 1)
+{
+    t_thread_idx = 0;
+    REND_PROFILE_THREAD("main");
+
+    for(uint32_t thread_idx = 0; thread_idx < _thread_datas.size(); ++thread_idx)
+    {
+        _thread_datas[thread_idx].steal_seed = thread_idx * 2654435761u + 1;
+    }
+
+    _workers.reserve(worker_count);
+    for(uint32_t idx = 0; idx < worker_count; ++idx)
+    {
+        _workers.emplace_back(&JobSystem::_worker_main, this, idx + 1);
+    }
+}
+
+JobSystem::~JobSystem(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shutdown.store(true);
+    }
+
+    _work_cv.notify_all();
+
+    for(auto& worker : _workers)
+    {
+        worker.join();
+    }
+
+    t_thread_idx = C_NO_THREAD;
+}
+
+uint32_t JobSystem::thread_count(void) const
+{
+    return static_cast<uint32_t>(_thread_datas.size());
+}
+
+uint32_t JobSystem::thread_index(void) const
+{
+    assert(t_thread_idx != C_NO_THREAD && "Thread does not belong to the job system");
+    return t_thread_idx;
+}
+
+Job* JobSystem::create_job(JobFunc func, Job* parent)
+{
+    Job* job = _allocate_job();
+    job->func = std::move(func);
+    job->parent = parent;
+
+    if(parent != nullptr)
+    {
+        parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+Job* JobSystem::create_parallel_for(uint32_t task_count, ParallelForFunc func, uint32_t grain)
+{
+    assert(grain > 0);
+
+    // Children are only created once this runs, so they wait on the same dependencies
+    Job* job = _allocate_job();
+    job->for_func = std::move(func);
+    job->for_end = task_count;
+    job->for_grain = grain;
+
+    return job;
+}
+
+void JobSystem::add_dependency(Job* job, Job* dependency)
+{
+    uint32_t count = dependency->dependents_count.load(std::memory_order_acquire);
+    while(true)
+    {
+        if(count == _CLOSED)
+        {
+            // Already complete
+            return;
+        }
+
+        assert(count < Job::_DEPENDENTS_MAX && "Too many jobs depend on one job");
+        if(dependency->dependents_count.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+
+    // Count the dependency before publishing the slot, completion waits for the slot before releasing the job
+    job->pending.fetch_add(1, std::memory_order_relaxed);
+    dependency->dependents[count].store(job, std::memory_order_release);
+}
+
+void JobSystem::submit(Job* job)
+{
+    _release(job);
+}
+
+void JobSystem::wait(Job* job)
+{
+    REND_PROFILE_ZONE("job_wait");
+    const uint32_t thread_idx = thread_index();
+    while(!is_complete(job))
+    {
+        Job* next = _find_job(thread_idx);
+        if(next != nullptr)
+        {
+            _execute(next, thread_idx);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::is_complete(const Job* job) const
+{
+    return job->complete.load(std::memory_order_acquire);
+}
+
+void JobSystem::parallel_for(uint32_t task_count, const ParallelForFunc& func, uint32_t grain)
+{
+    if(task_count == 0)
+    {
+        return;
+    }
+
+    // Not worth a job for a single chunk
+    if(task_count <= grain || _workers.empty())
+    {
+        const uint32_t thread_idx = thread_index();
+        for(uint32_t task_idx = 0; task_idx < task_count; ++task_idx)
+        {
+            func(task_idx, thread_idx);
+        }
+
+        return;
+    }
+
+    Job* job = create_parallel_for(task_count, func, grain);
+    submit(job);
+    wait(job);
+}
+
+Job* JobSystem::_allocate_job(void)
+{
+    const uint32_t thread_idx = thread_index();
+    ThreadData& thread_data = _thread_datas[thread_idx];
+
+    // Slots still in use, such as a parent held while its children are created, are skipped
+    Job* job = &thread_data.jobs[thread_data.next_job++ % _JOBS_PER_THREAD_MAX];
+    uint32_t probes = 1;
+    while(!job->complete.load(std::memory_order_acquire))
+    {
+        if(probes == _JOBS_PER_THREAD_MAX)
+        {
+            // Every slot is in use, jobs are created faster than they complete so run queued ones to free some
+            probes = 0;
+            Job* next = _find_job(thread_idx);
+            if(next != nullptr)
+            {
+                _execute(next, thread_idx);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        job = &thread_data.jobs[thread_data.next_job++ % _JOBS_PER_THREAD_MAX];
+        ++probes;
+    }
+
+    job->func = nullptr;
+    job->parent = nullptr;
+    job->for_func = nullptr;
+    job->for_source = nullptr;
+    job->for_begin = 0;
+    job->for_end = 0;
+    job->for_grain = 1;
+    job->unfinished.store(1, std::memory_order_relaxed);
+    job->pending.store(1, std::memory_order_relaxed);
+    job->dependents_count.store(0, std::memory_order_relaxed);
+    job->complete.store(false, std::memory_order_relaxed);
+    for(auto& dependent : job->dependents)
+    {
+        dependent.store(nullptr, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+void JobSystem::_release(Job* job)
+{
+    if(job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        _push(job);
+    }
+}
+
+void JobSystem::_push(Job* job)
+{
+    const uint32_t thread_idx = thread_index();
+    if(!_thread_datas[thread_idx].deque.push(job))
+    {
+        // Deque is full, there is plenty for everyone else to steal so just do this one now
+        _execute(job, thread_idx);
+        return;
+    }
+
+    _queued_jobs.fetch_add(1, std::memory_order_seq_cst);
+
+    // Pairs with the sleeping count a worker publishes before checking for queued jobs, so one of the two sees the other
+    if(_sleeping_workers.load(std::memory_order_seq_cst) > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+        }
+
+        _work_cv.notify_one();
+    }
+}
+
+Job* JobSystem::_find_job(uint32_t thread_idx)
+{
+    Job* job = nullptr;
+    ThreadData& thread_data = _thread_datas[thread_idx];
+
+    if(thread_data.deque.pop(job))
+    {
+        _queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    // Start from a random victim so thieves spread out instead of all hitting the same deque
+    const uint32_t threads_count = thread_count();
+    const uint32_t first_victim = next_random(thread_data.steal_seed) % threads_count;
+    for(uint32_t offset = 0; offset < threads_count; ++offset)
+    {
+        const uint32_t victim = (first_victim + offset) % threads_count;
+        if(victim != thread_idx && _thread_datas[victim].deque.steal(job))
+        {
+            _queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::_execute(Job* job, uint32_t thread_idx)
+{
+    if(job->for_source != nullptr)
+    {
+        for(uint32_t task_idx = job->for_begin; task_idx < job->for_end; ++task_idx)
+        {
+            job->for_source->for_func(task_idx, thread_idx);
+        }
+    }
+    else if(job->for_func)
+    {
+        // Split into children, the last chunk runs here rather than going through a deque
+        uint32_t begin = 0;
+        while(begin < job->for_end)
+        {
+            const uint32_t end = std::min(begin + job->for_grain, job->for_end);
+
+            Job* child = create_job(nullptr, job);
+            child->for_source = job;
+            child->for_begin = begin;
+            child->for_end = end;
+
+            if(end == job->for_end)
+            {
+                child->pending.store(0, std::memory_order_relaxed);
+                _execute(child, thread_idx);
+            }
+            else
+            {
+                submit(child);
+            }
+
+            begin = end;
+        }
+    }
+    else if(job->func)
+    {
+        job->func(thread_idx);
+    }
+
+    _finish(job);
+}
+
+void JobSystem::_finish(Job* job)
+{
+    if(job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    // Closing the list stops new dependents being added, anyone added before it is released here
+    const uint32_t dependents_count = job->dependents_count.exchange(_CLOSED, std::memory_order_acq_rel);
+    Job* parent = job->parent;
+
+    for(uint32_t idx = 0; idx < dependents_count; ++idx)
+    {
+        Job* dependent = nullptr;
+        while((dependent = job->dependents[idx].load(std::memory_order_acquire)) == nullptr)
+        {
+            std::this_thread::yield();
+        }
+
+        _release(dependent);
+    }
+
+    // Last touch, waiters may return and the slot may be reused as soon as this is seen
+    job->complete.store(true, std::memory_order_release);
+
+    if(parent != nullptr)
+    {
+        _finish(parent);
+    }
+}
+
+void JobSystem::_worker_main(uint32_t thread_idx)
+{
+    t_thread_idx = thread_idx;
+    REND_PROFILE_THREAD("job worker " + std::to_string(thread_idx));
+
+    uint32_t idle_spins = 0;
+    while(!_shutdown.load(std::memory_order_acquire))
+    {
+        Job* job = _find_job(thread_idx);
+        if(job != nullptr)
+        {
+            _execute(job, thread_idx);
+            idle_spins = 0;
+            continue;
+        }
+
+        if(++idle_spins < _SPINS_BEFORE_SLEEP)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+        _work_cv.wait(lock, [this]() { return _shutdown.load() || _queued_jobs.load(std::memory_order_seq_cst) > 0; });
+        _sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+        idle_spins = 0;
+    }
+}
@@ -22,6 +22,7 @@ const std::string& LogFile::get_filepath(void) const
 
 void LogFile::write(const std::string& output)
 {
-    _stream << output << std::endl;
-    _stream.flush();
+    std::lock_guard<std::mutex> lock(_stream_mutex);
+    // No per-line flush: writers share this lock, the stream flushes on close.
+    _stream << output << '\n';
 }
@@ -2,14 +2,21 @@
 
 #include "core/gpu_buffer.h"
 
+#include <algorithm>
+#include <assert.h>
+
 using namespace rend;
 
-Mesh::Mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer)
+Mesh::Mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer, const MeshRange& range)
     :
         GPUResource(name),
         _vertex_buffer(vertex_buffer),
-        _index_buffer(index_buffer)
+        _index_buffer(index_buffer),
+        _range(range)
 {
+    assert(vertex_buffer && "Meshes need a vertex buffer");
+    assert(range.vertex_offset >= 0 && range.vertex_offset + range.vertex_count <= vertex_buffer->elements_count() && "Mesh vertices outside the vertex buffer");
+    assert((!index_buffer || range.first_index + range.index_count <= index_buffer->elements_count()) && "Mesh indices outside the index buffer");
 }
 
 Mesh::~Mesh(void)
@@ -25,3 +32,69 @@ GPUBuffer* Mesh::get_index_buffer(void) const
 {
     return _index_buffer;
 }
+
+const MeshRange& Mesh::get_range(void) const
+{
+    return _range;
+}
+
+bool Mesh::has_bounds(void) const
+{
+    return _has_bounds;
+}
+
+const AABB& Mesh::get_aabb(void) const
+{
+    return _aabb;
+}
+
+const BoundingSphere& Mesh::get_bounding_sphere(void) const
+{
+    return _bounding_sphere;
+}
+
+void Mesh::compute_bounds(void)
+{
+    const size_t stride = _vertex_buffer->element_size();
+    const void* vertices = static_cast<const char*>(_vertex_buffer->data()) + _range.vertex_offset * stride;
+    const uint32_t vertex_count = _range.vertex_count;
+
+    AABB aabb = compute_aabb(vertices, stride, vertex_count);
+    set_bounds(aabb, compute_bounding_sphere(aabb, vertices, stride, vertex_count));
+}
+
+void Mesh::set_bounds(const AABB& aabb, const BoundingSphere& sphere)
+{
+    _aabb = aabb;
+    _bounding_sphere = sphere;
+    _has_bounds = true;
+}
+
+uint32_t Mesh::get_lods_count(void) const
+{
+    return _lods.empty() ? 1 : static_cast<uint32_t>(_lods.size());
+}
+
+MeshLOD Mesh::get_lod(uint32_t lod) const
+{
+    if(_lods.empty())
+    {
+        return MeshLOD{ _range.first_index, _range.index_count, 0.0f };
+    }
+
+    return MeshLOD{ _range.first_index + _lods[lod].first_index, _lods[lod].index_count, _lods[lod].error };
+}
+
+std::span<const MeshLOD> Mesh::get_lods(void) const
+{
+    return _lods;
+}
+
+void Mesh::set_lods(std::span<const MeshLOD> lods)
+{
+    assert(_index_buffer && "Levels of detail need an index buffer");
+    assert(lods.size() <= C_LODS_MAX && "Too many levels of detail");
+    assert(std::all_of(lods.begin(), lods.end(), [this](const MeshLOD& lod) { return lod.first_index + lod.index_count <= _range.index_count; }) && "Level of detail outside the mesh's indices");
+
+    _lods.assign(lods.begin(), lods.end());
+}
@@ -0,0 +1,399 @@
+#include "core/mesh_lod.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+using namespace rend;
+
+namespace
+{
+    const glm::vec3& vertex_position(const void* vertices, size_t stride, uint32_t idx)
+    {
+        return *reinterpret_cast<const glm::vec3*>(static_cast<const char*>(vertices) + stride * idx);
+    }
+
+    // Symmetric 4x4 matrix summing the squared distances to a set of planes
+    struct Quadric
+    {
+        double a00{ 0.0 }, a01{ 0.0 }, a02{ 0.0 }, a03{ 0.0 };
+        double a11{ 0.0 }, a12{ 0.0 }, a13{ 0.0 };
+        double a22{ 0.0 }, a23{ 0.0 };
+        double a33{ 0.0 };
+    };
+
+    void add_plane(Quadric& q, const glm::vec3& normal, float d)
+    {
+        q.a00 += normal.x * normal.x; q.a01 += normal.x * normal.y; q.a02 += normal.x * normal.z; q.a03 += normal.x * d;
+        q.a11 += normal.y * normal.y; q.a12 += normal.y * normal.z; q.a13 += normal.y * d;
+        q.a22 += normal.z * normal.z; q.a23 += normal.z * d;
+        q.a33 += d * d;
+    }
+
+    Quadric add_quadrics(const Quadric& lhs, const Quadric& rhs)
+    {
+        return Quadric{
+            lhs.a00 + rhs.a00, lhs.a01 + rhs.a01, lhs.a02 + rhs.a02, lhs.a03 + rhs.a03,
+            lhs.a11 + rhs.a11, lhs.a12 + rhs.a12, lhs.a13 + rhs.a13,
+            lhs.a22 + rhs.a22, lhs.a23 + rhs.a23,
+            lhs.a33 + rhs.a33
+        };
+    }
+
+    double evaluate_quadric(const Quadric& q, const glm::vec3& p)
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        const double error =
+            q.a00 * x * x + 2.0 * q.a01 * x * y + 2.0 * q.a02 * x * z + 2.0 * q.a03 * x +
+            q.a11 * y * y + 2.0 * q.a12 * y * z + 2.0 * q.a13 * y +
+            q.a22 * z * z + 2.0 * q.a23 * z +
+            q.a33;
+
+        return std::max(error, 0.0);
+    }
+
+    struct PositionKey
+    {
+        uint32_t bits[3];
+
+        bool operator==(const PositionKey& other) const
+        {
+            return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+        }
+    };
+
+    struct PositionKeyHash
+    {
+        size_t operator()(const PositionKey& key) const
+        {
+            return (size_t(key.bits[0]) * 73856093u) ^ (size_t(key.bits[1]) * 19349663u) ^ (size_t(key.bits[2]) * 83492791u);
+        }
+    };
+
+    // Vertices sharing a position are simplified as one, so seams in other attributes do not open cracks
+    std::vector<uint32_t> weld_positions(const void* vertices, size_t stride, uint32_t vertex_count)
+    {
+        std::vector<uint32_t> canonical(vertex_count);
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> first_vertex;
+        first_vertex.reserve(vertex_count);
+
+        for(uint32_t idx = 0; idx < vertex_count; ++idx)
+        {
+            PositionKey key{};
+            std::memcpy(key.bits, &vertex_position(vertices, stride, idx), sizeof(key.bits));
+            canonical[idx] = first_vertex.try_emplace(key, idx).first->second;
+        }
+
+        return canonical;
+    }
+
+    struct Collapse
+    {
+        double   cost{ 0.0 };
+        uint32_t from{ 0 };
+        uint32_t to{ 0 };
+    };
+
+    // Moving from onto to must not turn any triangle that survives the collapse over
+    bool collapse_keeps_orientation(
+        const void* vertices, size_t stride, const std::vector<uint32_t>& triangles,
+        const std::vector<uint32_t>& adjacency_offsets, const std::vector<uint32_t>& adjacency,
+        uint32_t from, uint32_t to)
+    {
+        const glm::vec3& to_position = vertex_position(vertices, stride, to);
+
+        for(uint32_t adjacent = adjacency_offsets[from]; adjacent < adjacency_offsets[from + 1]; ++adjacent)
+        {
+            const uint32_t* triangle = &triangles[adjacency[adjacent] * 3];
+            if(triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            {
+                continue;
+            }
+
+            glm::vec3 positions[3];
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                positions[corner] = vertex_position(vertices, stride, triangle[corner]);
+            }
+
+            const glm::vec3 normal_before = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                if(triangle[corner] == from)
+                {
+                    positions[corner] = to_position;
+                }
+            }
+
+            const glm::vec3 normal_after = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+            if(glm::dot(normal_before, normal_after) <= 0.0f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+std::vector<uint32_t> rend::simplify_indices(
+    const void* vertices, size_t stride, uint32_t vertex_count,
+    std::span<const uint32_t> indices, uint32_t target_index_count, float& out_error)
+{
+    out_error = 0.0f;
+
+    // Corners keep the vertex they index, triangles hold the welded vertex used to simplify
+    std::vector<uint32_t> corners(indices.begin(), indices.end());
+    if(corners.size() <= target_index_count)
+    {
+        return corners;
+    }
+
+    const std::vector<uint32_t> canonical = weld_positions(vertices, stride, vertex_count);
+
+    std::vector<uint32_t> triangles(corners.size());
+    for(size_t corner = 0; corner < corners.size(); ++corner)
+    {
+        triangles[corner] = canonical[corners[corner]];
+    }
+
+    // Each vertex starts with the planes of the triangles around it, collapses sum them
+    std::vector<Quadric> quadrics(vertex_count);
+    std::unordered_map<uint64_t, uint32_t> edge_uses;
+    edge_uses.reserve(triangles.size());
+
+    for(size_t first = 0; first < triangles.size(); first += 3)
+    {
+        const glm::vec3& p0 = vertex_position(vertices, stride, triangles[first]);
+        const glm::vec3& p1 = vertex_position(vertices, stride, triangles[first + 1]);
+        const glm::vec3& p2 = vertex_position(vertices, stride, triangles[first + 2]);
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const float length = glm::length(normal);
+        if(length > 0.0f)
+        {
+            normal /= length;
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                add_plane(quadrics[triangles[first + corner]], normal, -glm::dot(normal, p0));
+            }
+        }
+
+        for(uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const uint64_t a = triangles[first + corner];
+            const uint64_t b = triangles[first + (corner + 1) % 3];
+            ++edge_uses[(std::min(a, b) << 32) | std::max(a, b)];
+        }
+    }
+
+    // Vertices on open edges stay put, so borders do not shrink away
+    std::vector<uint8_t> locked(vertex_count, 0);
+    for(const auto& [edge, uses] : edge_uses)
+    {
+        if(uses == 1)
+        {
+            locked[edge >> 32] = 1;
+            locked[edge & 0xFFFFFFFF] = 1;
+        }
+    }
+
+    std::vector<uint32_t> adjacency_offsets;
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> collapse_to(vertex_count);
+    std::vector<uint8_t>  touched;
+    std::vector<Collapse> collapses;
+    double max_cost = 0.0;
+
+    // Each pass collapses the cheapest edges that do not share a triangle, then rebuilds the triangle list
+    while(triangles.size() > target_index_count)
+    {
+        const uint32_t triangle_count = static_cast<uint32_t>(triangles.size() / 3);
+
+        adjacency_offsets.assign(vertex_count + 1, 0);
+        for(uint32_t vertex : triangles)
+        {
+            ++adjacency_offsets[vertex + 1];
+        }
+
+        for(uint32_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            adjacency_offsets[vertex + 1] += adjacency_offsets[vertex];
+        }
+
+        adjacency.resize(triangles.size());
+        std::vector<uint32_t> adjacency_fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for(uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                adjacency[adjacency_fill[triangles[triangle * 3 + corner]]++] = triangle;
+            }
+        }
+
+        collapses.clear();
+        for(uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                // Shared edges turn up once in each direction, open edges are locked anyway
+                const uint32_t a = triangles[triangle * 3 + corner];
+                const uint32_t b = triangles[triangle * 3 + (corner + 1) % 3];
+                if(a > b)
+                {
+                    continue;
+                }
+
+                const Quadric quadric = add_quadrics(quadrics[a], quadrics[b]);
+                const double a_to_b = locked[a] ? std::numeric_limits<double>::infinity() : evaluate_quadric(quadric, vertex_position(vertices, stride, b));
+                const double b_to_a = locked[b] ? std::numeric_limits<double>::infinity() : evaluate_quadric(quadric, vertex_position(vertices, stride, a));
+
+                if(a_to_b <= b_to_a && a_to_b != std::numeric_limits<double>::infinity())
+                {
+                    collapses.push_back({ a_to_b, a, b });
+                }
+                else if(b_to_a < a_to_b)
+                {
+                    collapses.push_back({ b_to_a, b, a });
+                }
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+        touched.assign(vertex_count, 0);
+        for(uint32_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            collapse_to[vertex] = vertex;
+        }
+
+        uint32_t remaining = triangle_count;
+        bool collapsed = false;
+
+        for(const Collapse& collapse : collapses)
+        {
+            if(remaining * 3 <= target_index_count)
+            {
+                break;
+            }
+
+            if(touched[collapse.from] || touched[collapse.to] ||
+               !collapse_keeps_orientation(vertices, stride, triangles, adjacency_offsets, adjacency, collapse.from, collapse.to))
+            {
+                continue;
+            }
+
+            // Triangles around the collapse change, so nothing else may touch them this pass
+            for(uint32_t adjacent = adjacency_offsets[collapse.from]; adjacent < adjacency_offsets[collapse.from + 1]; ++adjacent)
+            {
+                const uint32_t* triangle = &triangles[adjacency[adjacent] * 3];
+                if(triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                {
+                    --remaining;
+                }
+
+                touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+            }
+
+            collapse_to[collapse.from] = collapse.to;
+            quadrics[collapse.to] = add_quadrics(quadrics[collapse.to], quadrics[collapse.from]);
+            max_cost = std::max(max_cost, collapse.cost);
+            collapsed = true;
+        }
+
+        if(!collapsed)
+        {
+            break;
+        }
+
+        // Move collapsed corners onto the vertex they collapsed to and drop the triangles that degenerated
+        size_t write = 0;
+        for(size_t first = 0; first < triangles.size(); first += 3)
+        {
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t vertex = triangles[first + corner];
+                if(collapse_to[vertex] != vertex)
+                {
+                    triangles[first + corner] = collapse_to[vertex];
+                    corners[first + corner] = collapse_to[vertex];
+                }
+            }
+
+            if(triangles[first] == triangles[first + 1] || triangles[first + 1] == triangles[first + 2] || triangles[first] == triangles[first + 2])
+            {
+                continue;
+            }
+
+            for(uint32_t corner = 0; corner < 3; ++corner)
+            {
+                triangles[write + corner] = triangles[first + corner];
+                corners[write + corner] = corners[first + corner];
+            }
+
+            write += 3;
+        }
+
+        triangles.resize(write);
+        corners.resize(write);
+    }
+
+    out_error = static_cast<float>(std::sqrt(max_cost));
+
+    return corners;
+}
+
+MeshLODChain rend::build_lod_chain(
+    const void* vertices, size_t stride, uint32_t vertex_count,
+    std::span<const uint32_t> indices, uint32_t lods_count, float reduction)
+{
+    MeshLODChain chain;
+    chain.indices.assign(indices.begin(), indices.end());
+    chain.lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+
+    std::vector<uint32_t> previous(indices.begin(), indices.end());
+    float error = 0.0f;
+
+    for(uint32_t lod = 1; lod < lods_count; ++lod)
+    {
+        const uint32_t target_index_count = static_cast<uint32_t>(previous.size() / 3 * reduction) * 3;
+
+        float lod_error = 0.0f;
+        std::vector<uint32_t> simplified = simplify_indices(vertices, stride, vertex_count, previous, target_index_count, lod_error);
+
+        // A level that barely removes anything is not worth drawing or storing
+        if(simplified.empty() || simplified.size() * 10 > previous.size() * 9)
+        {
+            break;
+        }
+
+        // Each level is simplified from the one before, so errors add up
+        error += lod_error;
+
+        chain.lods.push_back({ static_cast<uint32_t>(chain.indices.size()), static_cast<uint32_t>(simplified.size()), error });
+        chain.indices.insert(chain.indices.end(), simplified.begin(), simplified.end());
+        previous = std::move(simplified);
+    }
+
+    return chain;
+}
+
+uint32_t rend::select_lod(std::span<const MeshLOD> lods, float world_scale, float distance, float projection_scale, float threshold)
+{
+    // Projected error shrinks with distance, so take the coarsest level that is still within the threshold
+    const float pixels_per_unit = projection_scale * world_scale / std::max(distance, std::numeric_limits<float>::min());
+
+    for(uint32_t lod = static_cast<uint32_t>(lods.size()); lod > 1; --lod)
+    {
+        if(lods[lod - 1].error * pixels_per_unit <= threshold)
+        {
+            return lod - 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "core/pre_render_command.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace rend;
+
+namespace
+{
+    bool is_upload(const PreRenderCommand& command)
+    {
+        return command.type == PreRenderCommandType::BUFFER_UPLOAD || command.type == PreRenderCommandType::TEXTURE_UPLOAD;
+    }
+
+    const void* upload_resource(const PreRenderCommand& command)
+    {
+        return command.type == PreRenderCommandType::BUFFER_UPLOAD ? static_cast<const void*>(command.buffer) : static_cast<const void*>(command.texture);
+    }
+
+    bool upload_less(const PreRenderCommand& lhs, const PreRenderCommand& rhs)
+    {
+        if(lhs.type != rhs.type)
+        {
+            return lhs.type < rhs.type;
+        }
+
+        return std::less<const void*>{}(upload_resource(lhs), upload_resource(rhs));
+    }
+
+    bool upload_equal(const PreRenderCommand& lhs, const PreRenderCommand& rhs)
+    {
+        return lhs.type == rhs.type && upload_resource(lhs) == upload_resource(rhs);
+    }
+}
+
+void PreRenderCommandStream::push(const PreRenderCommand& command)
+{
+    _commands.push_back(command);
+}
+
+void PreRenderCommandStream::clear(void)
+{
+    _commands.clear();
+}
+
+bool PreRenderCommandStream::empty(void) const
+{
+    return _commands.empty();
+}
+
+std::span<const PreRenderCommand> PreRenderCommandStream::coalesce(void)
+{
+    auto out = _commands.begin();
+    auto it  = _commands.begin();
+
+    while(it != _commands.end())
+    {
+        if(!is_upload(*it))
+        {
+            *out++ = *it++;
+            continue;
+        }
+
+        // Uploads of different resources do not depend on each other, only transitions and callbacks order them
+        auto run_end = std::find_if_not(it, _commands.end(), is_upload);
+        std::sort(it, run_end, upload_less);
+        auto unique_end = std::unique(it, run_end, upload_equal);
+
+        out = std::move(it, unique_end, out);
+        it  = run_end;
+    }
+
+    _commands.erase(out, _commands.end());
+
+    return _commands;
+}
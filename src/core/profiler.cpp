@@ -0,0 +1,160 @@
+#include "core/profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define REND_PROFILE_RDTSC 1
+#endif
+
+using namespace rend;
+
+namespace
+{
+    struct Zone
+    {
+        const char* name{ nullptr };
+        uint64_t    begin{ 0 };
+        uint64_t    end{ 0 };
+    };
+
+    // Only its own thread writes zones, dumps read up to the published count
+    struct ThreadProfile
+    {
+        std::string           name;
+        uint32_t              id{ 0 };
+        std::vector<Zone>     zones;
+        std::atomic<uint64_t> count{ 0 };
+    };
+
+    // Both taken together once, so timestamps can be turned into microseconds since the process started profiling
+    struct ClockOrigin
+    {
+        uint64_t                              ticks{ Profiler::now() };
+        std::chrono::steady_clock::time_point time{ std::chrono::steady_clock::now() };
+    };
+
+    // Profiles are kept for the life of the process, a thread's zones are still wanted after it exits
+    std::mutex                  threads_mutex;
+    std::vector<ThreadProfile*> thread_profiles;
+    const ClockOrigin           clock_origin;
+
+    thread_local ThreadProfile* this_thread_profile{ nullptr };
+
+    ThreadProfile& get_thread_profile(size_t zones_max)
+    {
+        if(this_thread_profile == nullptr)
+        {
+            auto* profile = new ThreadProfile;
+            profile->zones.resize(zones_max);
+
+            std::lock_guard<std::mutex> lock(threads_mutex);
+            profile->id = static_cast<uint32_t>(thread_profiles.size());
+            profile->name = "thread " + std::to_string(profile->id);
+            thread_profiles.push_back(profile);
+            this_thread_profile = profile;
+        }
+
+        return *this_thread_profile;
+    }
+
+    void write_escaped(std::ofstream& out, const char* text)
+    {
+        for(; *text != '\0'; ++text)
+        {
+            if(*text == '"' || *text == '\\')
+            {
+                out << '\\';
+            }
+
+            out << *text;
+        }
+    }
+
+    double ticks_per_microsecond(void)
+    {
+#if REND_PROFILE_RDTSC
+        // Assumes an invariant TSC, calibrated over everything recorded so far
+        const uint64_t ticks = Profiler::now() - clock_origin.ticks;
+        const double   microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - clock_origin.time).count();
+        return microseconds > 0.0 ? static_cast<double>(ticks) / microseconds : 1.0;
+#else
+        return 1000.0;
+#endif
+    }
+}
+
+void Profiler::set_thread_name(const std::string& name)
+{
+    ThreadProfile& profile = get_thread_profile(_ZONES_PER_THREAD_MAX);
+
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    profile.name = name;
+}
+
+uint64_t Profiler::now(void)
+{
+#if REND_PROFILE_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void Profiler::record(const char* name, uint64_t begin, uint64_t end)
+{
+    ThreadProfile& profile = get_thread_profile(_ZONES_PER_THREAD_MAX);
+
+    const uint64_t idx = profile.count.load(std::memory_order_relaxed);
+    profile.zones[idx % _ZONES_PER_THREAD_MAX] = { name, begin, end };
+    profile.count.store(idx + 1, std::memory_order_release);
+}
+
+bool Profiler::write_chrome_trace(const std::string& path)
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if(!out.is_open())
+    {
+        return false;
+    }
+
+    const double ticks_per_us = ticks_per_microsecond();
+    char number[64];
+
+    std::lock_guard<std::mutex> lock(threads_mutex);
+
+    out << "{\"traceEvents\":[";
+    bool first_event = true;
+
+    for(const ThreadProfile* profile : thread_profiles)
+    {
+        out << (first_event ? "\n" : ",\n");
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << profile->id << ",\"args\":{\"name\":\"";
+        write_escaped(out, profile->name.c_str());
+        out << "\"}}";
+        first_event = false;
+
+        const uint64_t count = profile->count.load(std::memory_order_acquire);
+        const uint64_t first = count > _ZONES_PER_THREAD_MAX ? count - _ZONES_PER_THREAD_MAX : 0;
+        for(uint64_t idx = first; idx < count; ++idx)
+        {
+            const Zone& zone = profile->zones[idx % _ZONES_PER_THREAD_MAX];
+            const double begin_us    = static_cast<double>(zone.begin - clock_origin.ticks) / ticks_per_us;
+            const double duration_us = static_cast<double>(zone.end - zone.begin) / ticks_per_us;
+
+            out << ",\n{\"name\":\"";
+            write_escaped(out, zone.name);
+            snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", begin_us, duration_us);
+            out << number << ",\"pid\":1,\"tid\":" << profile->id << "}";
+        }
+    }
+
+    out << "\n]}\n";
+
+    return out.good();
+}
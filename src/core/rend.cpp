@@ -1,9 +1,11 @@
 #include "core/rend.h"
 
+#include "core/job_system.h"
 #include "core/renderer.h"
 #include "core/logging/log_manager.h"
 
 #include <GLFW/glfw3.h>
+#include <thread>
 
 using namespace rend;
 using namespace rend::core;
@@ -12,6 +14,16 @@ void rend::rend_initialise(const RendInitInfo& init_info)
 {
     glfwInit();
     logging::LogManager::initialise();
+
+    // The initialising thread works as well whenever it waits, so leave a core for it
+    uint32_t worker_threads = init_info.worker_threads;
+    if(worker_threads == C_WORKER_THREADS_AUTO)
+    {
+        const uint32_t hardware_threads = std::thread::hardware_concurrency();
+        worker_threads = hardware_threads > 1 ? hardware_threads - 1 : 0;
+    }
+
+    JobSystem::initialise(worker_threads);
     Renderer::initialise(init_info);
     Renderer::get_instance().configure();
 }
@@ -19,6 +31,7 @@ void rend::rend_initialise(const RendInitInfo& init_info)
 void rend::rend_uninitialise(void)
 {
     Renderer::get_instance().shutdown();
+    JobSystem::uninitialise();
     logging::LogManager::uninitialise();
     glfwTerminate();
 }
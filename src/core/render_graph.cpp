@@ -0,0 +1,467 @@
+#include "core/render_graph.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace rend;
+
+namespace
+{
+    struct UsageState
+    {
+        ImageLayout    layout{ ImageLayout::UNDEFINED };
+        PipelineStages stages{ PipelineStage::PIPELINE_STAGE_NONE };
+        MemoryAccesses accesses{ MemoryAccess::NO_ACCESS };
+    };
+
+    UsageState get_usage_state(RenderGraphUsage usage, bool write)
+    {
+        switch(usage)
+        {
+            case RenderGraphUsage::COLOUR_ATTACHMENT:
+                return { ImageLayout::COLOUR_ATTACHMENT, PipelineStage::PIPELINE_STAGE_COLOUR_OUTPUT,
+                         write ? MemoryAccess::COLOUR_ATTACHMENT_WRITE : MemoryAccess::COLOUR_ATTACHMENT_READ };
+            case RenderGraphUsage::DEPTH_STENCIL_ATTACHMENT:
+                return { ImageLayout::DEPTH_STENCIL_ATTACHMENT, PipelineStage::PIPELINE_STAGE_EARLY_FRAGMENT_TEST | PipelineStage::PIPELINE_STAGE_LATE_FRAGMENT_TEST,
+                         write ? MemoryAccesses(MemoryAccess::DEPTH_STENCIL_ATTACHMENT_READ | MemoryAccess::DEPTH_STENCIL_ATTACHMENT_WRITE) : MemoryAccesses(MemoryAccess::DEPTH_STENCIL_ATTACHMENT_READ) };
+            case RenderGraphUsage::SHADER:
+                return { write ? ImageLayout::GENERAL : ImageLayout::SHADER_READ_ONLY, PipelineStage::PIPELINE_STAGE_VERTEX_SHADER | PipelineStage::PIPELINE_STAGE_FRAGMENT_SHADER,
+                         write ? MemoryAccess::SHADER_WRITE : MemoryAccess::SHADER_READ };
+            case RenderGraphUsage::TRANSFER:
+                return { write ? ImageLayout::TRANSFER_DST : ImageLayout::TRANSFER_SRC, PipelineStage::PIPELINE_STAGE_TRANSFER,
+                         write ? MemoryAccess::TRANSFER_WRITE : MemoryAccess::TRANSFER_READ };
+            case RenderGraphUsage::PRESENT:
+                assert(!write && "Presenting only reads a resource");
+                return { ImageLayout::PRESENT, PipelineStage::PIPELINE_STAGE_BOTTOM_OF_PIPE, MemoryAccess::NO_ACCESS };
+        }
+
+        return {};
+    }
+
+    // Accesses to a resource since it was last written, used to find what the next use has to wait for
+    struct ResourceState
+    {
+        ImageLayout    layout{ ImageLayout::UNDEFINED };
+        PipelineStages write_stages{ PipelineStage::PIPELINE_STAGE_NONE };
+        MemoryAccesses write_accesses{ MemoryAccess::NO_ACCESS };
+        PipelineStages visible_stages{ PipelineStage::PIPELINE_STAGE_NONE }; // Stages the last write has been made visible to
+        PipelineStages read_stages{ PipelineStage::PIPELINE_STAGE_NONE };
+    };
+}
+
+RenderGraphResource RenderGraph::add_resource(const std::string& name, ImageLayout initial_layout)
+{
+    assert(find_resource(name) == C_RENDER_GRAPH_NULL && "Render graph resource names must be unique");
+
+    Resource resource{};
+    resource.name           = name;
+    resource.initial_layout = initial_layout;
+    resource.final_layout   = initial_layout;
+    _resources.push_back(resource);
+
+    return static_cast<RenderGraphResource>(_resources.size() - 1);
+}
+
+void RenderGraph::set_texture(RenderGraphResource resource, GPUTexture* texture)
+{
+    _resources[resource].texture = texture;
+}
+
+void RenderGraph::mark_output(RenderGraphResource resource)
+{
+    _resources[resource].output = true;
+}
+
+RenderGraphPass RenderGraph::add_pass(const std::string& name, RenderGraphPassCallback callback, void* user_data)
+{
+    Pass pass{};
+    pass.name      = name;
+    pass.callback  = callback;
+    pass.user_data = user_data;
+    _passes.push_back(pass);
+
+    return static_cast<RenderGraphPass>(_passes.size() - 1);
+}
+
+void RenderGraph::set_side_effects(RenderGraphPass pass)
+{
+    _passes[pass].side_effects = true;
+}
+
+void RenderGraph::read(RenderGraphPass pass, RenderGraphResource resource, RenderGraphUsage usage)
+{
+    _add_use(pass, resource, usage, false);
+}
+
+void RenderGraph::write(RenderGraphPass pass, RenderGraphResource resource, RenderGraphUsage usage)
+{
+    _add_use(pass, resource, usage, true);
+}
+
+void RenderGraph::compile(void)
+{
+    _build_edges();
+    _cull_passes();
+    _order_passes();
+    _build_barriers();
+}
+
+void RenderGraph::clear(void)
+{
+    _resources.clear();
+    _passes.clear();
+    _edges.clear();
+    _pass_order.clear();
+    _barriers.clear();
+}
+
+RenderGraphResource RenderGraph::find_resource(const std::string& name) const
+{
+    for(size_t idx = 0; idx < _resources.size(); ++idx)
+    {
+        if(_resources[idx].name == name)
+        {
+            return static_cast<RenderGraphResource>(idx);
+        }
+    }
+
+    return C_RENDER_GRAPH_NULL;
+}
+
+const std::string& RenderGraph::get_resource_name(RenderGraphResource resource) const
+{
+    return _resources[resource].name;
+}
+
+GPUTexture* RenderGraph::get_texture(RenderGraphResource resource) const
+{
+    return _resources[resource].texture;
+}
+
+ImageLayout RenderGraph::get_final_layout(RenderGraphResource resource) const
+{
+    return _resources[resource].final_layout;
+}
+
+const std::string& RenderGraph::get_pass_name(RenderGraphPass pass) const
+{
+    return _passes[pass].name;
+}
+
+bool RenderGraph::is_culled(RenderGraphPass pass) const
+{
+    return _passes[pass].culled;
+}
+
+void RenderGraph::execute_pass(RenderGraphPass pass, CommandBuffer& command_buffer) const
+{
+    if(_passes[pass].callback)
+    {
+        _passes[pass].callback(command_buffer, _passes[pass].user_data);
+    }
+}
+
+std::span<const RenderGraphPass> RenderGraph::get_pass_order(void) const
+{
+    return _pass_order;
+}
+
+std::span<const RenderGraphBarrier> RenderGraph::get_barriers(RenderGraphPass pass) const
+{
+    return std::span<const RenderGraphBarrier>(_barriers).subspan(_passes[pass].barriers_begin, _passes[pass].barriers_count);
+}
+
+void RenderGraph::_add_use(RenderGraphPass pass, RenderGraphResource resource, RenderGraphUsage usage, bool write)
+{
+    assert(pass < _passes.size() && resource < _resources.size());
+
+    // Several uses of one resource in a pass share a layout, so they are synchronised together
+    for(const Use& use : _passes[pass].uses)
+    {
+        assert((use.resource != resource || get_usage_state(use.usage, use.write).layout == get_usage_state(usage, write).layout) &&
+               "A pass can only use a resource in one layout");
+    }
+
+    _passes[pass].uses.push_back({ resource, usage, write });
+}
+
+void RenderGraph::_build_edges(void)
+{
+    _edges.clear();
+
+    std::vector<RenderGraphPass>              last_writers(_resources.size(), C_RENDER_GRAPH_NULL);
+    std::vector<std::vector<RenderGraphPass>> readers(_resources.size());
+
+    for(RenderGraphPass pass_idx = 0; pass_idx < _passes.size(); ++pass_idx)
+    {
+        const Pass& pass = _passes[pass_idx];
+
+        // Reads first, so a pass that reads and writes a resource depends on the pass before it, not itself
+        for(const Use& use : pass.uses)
+        {
+            if(use.write)
+            {
+                continue;
+            }
+
+            if(last_writers[use.resource] != C_RENDER_GRAPH_NULL)
+            {
+                _edges.push_back({ last_writers[use.resource], pass_idx, true });
+            }
+
+            readers[use.resource].push_back(pass_idx);
+        }
+
+        for(const Use& use : pass.uses)
+        {
+            if(!use.write)
+            {
+                continue;
+            }
+
+            // Attachments may be loaded, so a write keeps the previous write alive
+            if(last_writers[use.resource] != C_RENDER_GRAPH_NULL && last_writers[use.resource] != pass_idx)
+            {
+                _edges.push_back({ last_writers[use.resource], pass_idx, true });
+            }
+
+            for(RenderGraphPass reader : readers[use.resource])
+            {
+                if(reader != pass_idx)
+                {
+                    _edges.push_back({ reader, pass_idx, false });
+                }
+            }
+
+            last_writers[use.resource] = pass_idx;
+            readers[use.resource].clear();
+        }
+    }
+
+    // Roots of the live set, passes with side effects and whatever last writes an output
+    for(Pass& pass : _passes)
+    {
+        pass.culled = !pass.side_effects;
+    }
+
+    for(RenderGraphResource resource_idx = 0; resource_idx < _resources.size(); ++resource_idx)
+    {
+        if(_resources[resource_idx].output && last_writers[resource_idx] != C_RENDER_GRAPH_NULL)
+        {
+            _passes[last_writers[resource_idx]].culled = false;
+        }
+    }
+}
+
+void RenderGraph::_cull_passes(void)
+{
+    std::vector<RenderGraphPass> stack;
+    for(RenderGraphPass pass_idx = 0; pass_idx < _passes.size(); ++pass_idx)
+    {
+        if(!_passes[pass_idx].culled)
+        {
+            stack.push_back(pass_idx);
+        }
+    }
+
+    // Walk live edges backwards from the roots, anything not reached produces nothing that is used
+    while(!stack.empty())
+    {
+        RenderGraphPass pass_idx = stack.back();
+        stack.pop_back();
+
+        for(const Edge& edge : _edges)
+        {
+            if(edge.live && edge.to == pass_idx && _passes[edge.from].culled)
+            {
+                _passes[edge.from].culled = false;
+                stack.push_back(edge.from);
+            }
+        }
+    }
+}
+
+void RenderGraph::_order_passes(void)
+{
+    _pass_order.clear();
+
+    std::vector<uint32_t> dependencies_count(_passes.size(), 0);
+    for(const Edge& edge : _edges)
+    {
+        if(!_passes[edge.from].culled && !_passes[edge.to].culled)
+        {
+            ++dependencies_count[edge.to];
+        }
+    }
+
+    std::vector<RenderGraphPass> ready;
+    for(RenderGraphPass pass_idx = 0; pass_idx < _passes.size(); ++pass_idx)
+    {
+        if(!_passes[pass_idx].culled && dependencies_count[pass_idx] == 0)
+        {
+            ready.push_back(pass_idx);
+        }
+    }
+
+    auto depends_on = [this](RenderGraphPass pass, RenderGraphPass on)
+    {
+        return std::any_of(_edges.begin(), _edges.end(), [pass, on](const Edge& edge) { return edge.from == on && edge.to == pass; });
+    };
+
+    // Prefer a ready pass that does not wait on the one just scheduled, so the GPU has independent work
+    // between a producer and its consumer instead of draining at every barrier. Ties keep declaration order.
+    while(!ready.empty())
+    {
+        size_t pick = 0;
+        if(!_pass_order.empty())
+        {
+            for(size_t idx = 0; idx < ready.size(); ++idx)
+            {
+                const bool pick_waits = depends_on(ready[pick], _pass_order.back());
+                const bool idx_waits  = depends_on(ready[idx], _pass_order.back());
+                if((pick_waits && !idx_waits) || (pick_waits == idx_waits && ready[idx] < ready[pick]))
+                {
+                    pick = idx;
+                }
+            }
+        }
+        else
+        {
+            pick = std::min_element(ready.begin(), ready.end()) - ready.begin();
+        }
+
+        RenderGraphPass pass_idx = ready[pick];
+        ready.erase(ready.begin() + pick);
+        _pass_order.push_back(pass_idx);
+
+        for(const Edge& edge : _edges)
+        {
+            if(edge.from == pass_idx && !_passes[edge.to].culled && --dependencies_count[edge.to] == 0)
+            {
+                ready.push_back(edge.to);
+            }
+        }
+    }
+
+    assert(std::count_if(_passes.begin(), _passes.end(), [](const Pass& pass) { return !pass.culled; }) == (ptrdiff_t)_pass_order.size() &&
+           "Render graph passes form a cycle");
+}
+
+void RenderGraph::_build_barriers(void)
+{
+    _barriers.clear();
+
+    std::vector<ResourceState> states(_resources.size());
+    for(RenderGraphResource resource_idx = 0; resource_idx < _resources.size(); ++resource_idx)
+    {
+        states[resource_idx].layout = _resources[resource_idx].initial_layout;
+    }
+
+    for(Pass& pass : _passes)
+    {
+        pass.barriers_begin = 0;
+        pass.barriers_count = 0;
+    }
+
+    for(RenderGraphPass pass_idx : _pass_order)
+    {
+        Pass& pass = _passes[pass_idx];
+        pass.barriers_begin = static_cast<uint32_t>(_barriers.size());
+
+        for(size_t use_idx = 0; use_idx < pass.uses.size(); ++use_idx)
+        {
+            const RenderGraphResource resource = pass.uses[use_idx].resource;
+
+            // Merge every use of the resource in this pass, handling it at its first use
+            bool first_use = true;
+            for(size_t prev_idx = 0; prev_idx < use_idx; ++prev_idx)
+            {
+                first_use &= pass.uses[prev_idx].resource != resource;
+            }
+
+            if(!first_use)
+            {
+                continue;
+            }
+
+            UsageState need{};
+            bool write = false;
+            for(size_t merge_idx = use_idx; merge_idx < pass.uses.size(); ++merge_idx)
+            {
+                const Use& use = pass.uses[merge_idx];
+                if(use.resource == resource)
+                {
+                    UsageState use_state = get_usage_state(use.usage, use.write);
+                    need.layout    = use_state.layout;
+                    need.stages   |= use_state.stages;
+                    need.accesses |= use_state.accesses;
+                    write         |= use.write;
+                }
+            }
+
+            ResourceState& state = states[resource];
+            const bool layout_change = state.layout != need.layout;
+
+            RenderGraphBarrier barrier{};
+            barrier.resource     = resource;
+            barrier.dst_stages   = need.stages;
+            barrier.dst_accesses = need.accesses;
+            barrier.old_layout   = state.layout;
+            barrier.new_layout   = need.layout;
+
+            bool needs_barrier = false;
+            if(write || layout_change)
+            {
+                // Wait for the last write and every read since, a layout change is itself a write
+                barrier.src_stages   = state.write_stages | state.read_stages;
+                barrier.src_accesses = state.write_accesses;
+                needs_barrier = layout_change || barrier.src_stages != PipelineStage::PIPELINE_STAGE_NONE;
+            }
+            else if(state.write_stages != PipelineStage::PIPELINE_STAGE_NONE && (need.stages & ~state.visible_stages) != 0)
+            {
+                // Read after write in stages the write has not been made visible to yet
+                barrier.src_stages   = state.write_stages;
+                barrier.src_accesses = state.write_accesses;
+                needs_barrier = true;
+            }
+
+            if(needs_barrier)
+            {
+                if(barrier.src_stages == PipelineStage::PIPELINE_STAGE_NONE)
+                {
+                    barrier.src_stages = PipelineStage::PIPELINE_STAGE_TOP_OF_PIPE;
+                }
+
+                _barriers.push_back(barrier);
+            }
+
+            state.layout = need.layout;
+            if(write)
+            {
+                state.write_stages   = need.stages;
+                state.write_accesses = need.accesses;
+                state.visible_stages = PipelineStage::PIPELINE_STAGE_NONE;
+                state.read_stages    = PipelineStage::PIPELINE_STAGE_NONE;
+            }
+            else if(layout_change)
+            {
+                // Later readers in other stages chain off this barrier, which did the transition
+                state.write_stages   = need.stages;
+                state.visible_stages = need.stages;
+                state.read_stages    = need.stages;
+            }
+            else
+            {
+                state.visible_stages = needs_barrier ? state.visible_stages | need.stages : state.visible_stages;
+                state.read_stages   |= need.stages;
+            }
+        }
+
+        pass.barriers_count = static_cast<uint32_t>(_barriers.size()) - pass.barriers_begin;
+    }
+
+    for(RenderGraphResource resource_idx = 0; resource_idx < _resources.size(); ++resource_idx)
+    {
+        _resources[resource_idx].final_layout = states[resource_idx].layout;
+    }
+}
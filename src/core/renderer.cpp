@@ -2,15 +2,31 @@
 
 #include "core/descriptor_set.h"
 #include "core/descriptor_pool.h"
+#include "core/gpu_buffer.h"
 #include "core/rend.h"
 #include "core/window.h"
 
 #include "api/vulkan/vulkan_renderer.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
 
 using namespace rend;
 
+namespace
+{
+    // Each thread caches its submission list, so only its first submission to a renderer takes a lock
+    struct ThreadDrawItems
+    {
+        uint64_t      renderer_id{ 0 };
+        DrawItemList* draw_items{ nullptr };
+    };
+
+    thread_local ThreadDrawItems t_draw_items;
+    std::atomic<uint64_t> s_next_renderer_id{ 1 };
+}
+
 Renderer* Renderer::_renderer =  nullptr;
 
 void Renderer::initialise(const RendInitInfo& init_info)
@@ -25,9 +41,17 @@ void Renderer::initialise(const RendInitInfo& init_info)
     }
 }
 
-Renderer::~Renderer(void)
+Renderer::Renderer(void)
+    : _renderer_id(s_next_renderer_id.fetch_add(1, std::memory_order_relaxed))
 {
+}
 
+Renderer::~Renderer(void)
+{
+    for(auto* draw_items : _draw_item_lists)
+    {
+        delete draw_items;
+    }
 }
 
 void Renderer::shutdown(void)
@@ -48,12 +72,121 @@ Window* Renderer::get_window(void) const
 
 void Renderer::add_draw_item(const DrawItem& item)
 {
-    _draw_items.push_back(item);
+    _get_thread_draw_items().push_back(item);
+}
+
+void Renderer::add_draw_items(std::span<const DrawItem> items)
+{
+    _get_thread_draw_items().append(items);
+}
+
+RendHandle Renderer::add_retained_draw_item(const DrawItem& item)
+{
+    assert(_retained_draw_item_handles.size() < _retained_draw_item_handles.capacity());
+
+    auto rend_handle = _retained_draw_item_handles.allocate(0u);
+    uint32_t slot = static_cast<uint32_t>(rend_handle & c_index_mask);
+    *_retained_draw_item_handles.get(rend_handle) = slot;
+
+    if(slot >= _retained_draw_items.size())
+    {
+        _retained_draw_items.resize(slot + 1);
+        _retained_draw_item_flags.resize(slot + 1, 0);
+    }
+
+    _retained_draw_items.set(slot, item);
+    _retained_draw_item_flags[slot] |= _RETAINED_DRAW_ITEM_DIRTY;
+    _retained_dirty_handles.push_back(rend_handle);
+
+    return rend_handle;
+}
+
+void Renderer::update_retained_draw_item(RendHandle handle, const DrawItem& item)
+{
+    auto* slot = _retained_draw_item_handles.get(handle);
+    assert(slot && "Updating retained draw item that does not exist");
+
+    _retained_draw_items.set(*slot, item);
+
+    uint8_t& flags = _retained_draw_item_flags[*slot];
+    if(!(flags & _RETAINED_DRAW_ITEM_STALE))
+    {
+        flags |= _RETAINED_DRAW_ITEM_STALE;
+        ++_retained_stale_count;
+    }
+
+    if(!(flags & _RETAINED_DRAW_ITEM_DIRTY))
+    {
+        flags |= _RETAINED_DRAW_ITEM_DIRTY;
+        _retained_dirty_handles.push_back(handle);
+    }
+}
+
+void Renderer::remove_retained_draw_item(RendHandle handle)
+{
+    assert(_retained_draw_item_handles.check_valid(handle) && "Removing retained draw item that does not exist");
+
+    // The handle may still sit in the dirty list, it fails validation there once deallocated
+    uint8_t& flags = _retained_draw_item_flags[handle & c_index_mask];
+    if(!(flags & _RETAINED_DRAW_ITEM_STALE))
+    {
+        flags |= _RETAINED_DRAW_ITEM_STALE;
+        ++_retained_stale_count;
+    }
+
+    flags &= ~_RETAINED_DRAW_ITEM_DIRTY;
+
+    _retained_draw_item_handles.deallocate(handle);
+}
+
+DrawItemList& Renderer::_get_thread_draw_items(void)
+{
+    if(t_draw_items.renderer_id != _renderer_id)
+    {
+        std::lock_guard<std::mutex> lock(_draw_item_lists_mutex);
+
+        t_draw_items.renderer_id = _renderer_id;
+        t_draw_items.draw_items = _draw_item_lists.emplace_back(new DrawItemList);
+    }
+
+    return *t_draw_items.draw_items;
+}
+
+void* Renderer::allocate_draw_data(size_t bytes)
+{
+    return _frame_datas[_current_frame].draw_data_arena->allocate(bytes);
+}
+
+TransientAllocation Renderer::allocate_transient(TransientUsage usage, size_t bytes)
+{
+    return _transient_allocator->allocate(usage, bytes);
 }
 
-void Renderer::add_pre_render_task(std::function<void(void)> func)
+GPUBuffer& Renderer::get_transient_buffer(void) const
 {
-    _pre_render_queue.push(func);
+    return _transient_allocator->buffer();
+}
+
+void Renderer::add_pre_render_task(PreRenderCallback callback, void* user_data)
+{
+    PreRenderCommand command{};
+    command.type      = PreRenderCommandType::CALLBACK;
+    command.callback  = callback;
+    command.user_data = user_data;
+
+    _pre_render_commands.push(command);
+}
+
+void Renderer::add_pre_render_transition(GPUTexture& texture, PipelineStages src_stages, PipelineStages dst_stages, ImageLayout layout)
+{
+    PreRenderCommand command{};
+    command.type       = PreRenderCommandType::TRANSITION;
+    command.layout     = layout;
+    command.src_stages = src_stages;
+    command.dst_stages = dst_stages;
+    command.texture    = &texture;
+
+    _pre_render_commands.push(command);
 }
 
 //void Renderer::add_point_light(glm::vec3 position, const PointLight& light)
@@ -108,9 +241,29 @@ Material* Renderer::create_material(const std::string& name, const MaterialInfo&
 
 Mesh* Renderer::create_mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer)
 {
-    auto rend_handle = _meshes.allocate(name, vertex_buffer, index_buffer);
+    const MeshRange range =
+    {
+        .vertex_offset = 0,
+        .vertex_count  = vertex_buffer->elements_count(),
+        .first_index   = 0,
+        .index_count   = index_buffer ? index_buffer->elements_count() : 0
+    };
+
+    return create_mesh(name, vertex_buffer, index_buffer, range);
+}
+
+Mesh* Renderer::create_mesh(const std::string& name, GPUBuffer* vertex_buffer, GPUBuffer* index_buffer, const MeshRange& range)
+{
+    auto rend_handle = _meshes.allocate(name, vertex_buffer, index_buffer, range);
     auto* mesh = _meshes.get(rend_handle);
     mesh->_rend_handle = rend_handle;
+
+    // Vertex data is stored ahead of creating the mesh, so culling has bounds from the first frame
+    if(range.vertex_count > 0 && vertex_buffer->element_size() >= sizeof(glm::vec3))
+    {
+        mesh->compute_bounds();
+    }
+
     return mesh;
 }
 
@@ -234,11 +387,72 @@ void Renderer::destroy_view(View* view)
     _views.deallocate(rend_handle);
 }
 
+const CommandBufferStats& Renderer::get_command_buffer_stats(void) const
+{
+    return _command_buffer_stats;
+}
+
+const CullStats& Renderer::get_cull_stats(void) const
+{
+    return _cull_stats;
+}
+
+const std::vector<GPUPassTiming>& Renderer::get_gpu_pass_timings(void) const
+{
+    return _gpu_pass_timings;
+}
+
+void Renderer::set_lod_error_threshold(float pixels)
+{
+    _lod_error_threshold = pixels;
+}
+
+float Renderer::get_lod_error_threshold(void) const
+{
+    return _lod_error_threshold;
+}
+
 PresentationMode Renderer::get_presentation_mode(void) const
 {
     return _presentation_mode;
 }
 
+uint32_t Renderer::get_frames_in_flight(void) const
+{
+    return _frames_in_flight;
+}
+
+void Renderer::_configure_frame_pacing(const RendInitInfo& init_info)
+{
+    switch(init_info.latency_mode)
+    {
+        case LatencyMode::CUSTOM:
+            _frames_in_flight = init_info.frames_in_flight;
+            _swapchain_images = init_info.swapchain_images;
+            _present_mode = init_info.present_mode;
+            break;
+
+        // The CPU never gets more than a frame ahead, and a frame that misses its vertical blank is replaced by a newer one
+        case LatencyMode::LOW_LATENCY:
+            _frames_in_flight = 1;
+            _swapchain_images = 2;
+            _present_mode = PresentMode::MAILBOX;
+            break;
+
+        // Deeper queues keep the GPU fed through CPU spikes, at the cost of frames waiting longer to be shown
+        case LatencyMode::HIGH_THROUGHPUT:
+            _frames_in_flight = 3;
+            _swapchain_images = 4;
+            _present_mode = PresentMode::FIFO;
+            break;
+    }
+
+    assert(_frames_in_flight >= _FRAMES_IN_FLIGHT_MIN && _frames_in_flight <= _FRAMES_IN_FLIGHT_MAX && "Frames in flight must be 1 to 4");
+    _frames_in_flight = std::clamp(_frames_in_flight, _FRAMES_IN_FLIGHT_MIN, _FRAMES_IN_FLIGHT_MAX);
+
+    _frame_datas.resize(_frames_in_flight);
+}
+
 //DrawPass* Renderer::get_draw_pass(const std::string& name) const
 //{
 //    for(const DrawPass& draw_pass : _draw_passes)
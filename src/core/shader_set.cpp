@@ -29,7 +29,17 @@ const DescriptorSetLayout& ShaderSet::get_descriptor_set_layout(DescriptorFreque
     return *_info.layouts[freq];
 }
 
+bool ShaderSet::has_descriptor_set_layout(DescriptorFrequency freq) const
+{
+    return _info.layouts[freq] != nullptr;
+}
+
 const std::vector<VertexBindingInfo>& ShaderSet::get_vertex_bindings(void) const
 {
     return _info.binding_info;
 }
+
+uint32_t ShaderSet::get_instance_data_stride(void) const
+{
+    return _info.instance_data_stride;
+}
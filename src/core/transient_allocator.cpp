@@ -0,0 +1,80 @@
+#include "core/transient_allocator.h"
+
+#include "core/gpu_buffer.h"
+#include "core/rend_utils.h"
+
+#include <assert.h>
+#include <bit>
+
+using namespace rend;
+
+TransientAllocator::TransientAllocator(GPUBuffer& buffer, void* mapped, uint32_t frames_in_flight, const Alignments& alignments)
+    :
+        _buffer(buffer),
+        _mapped(static_cast<char*>(mapped)),
+        _alignments(alignments),
+        _regions(frames_in_flight)
+{
+    assert(_mapped != nullptr && "Transient memory must be host visible");
+
+    for(uint32_t alignment : _alignments)
+    {
+        assert(std::has_single_bit(alignment) && alignment <= C_REGION_ALIGNMENT);
+        (void)alignment;
+    }
+
+    _region_bytes = static_cast<uint32_t>((_buffer.bytes() / frames_in_flight) & ~size_t(C_REGION_ALIGNMENT - 1));
+
+    for(uint32_t idx = 0; idx < frames_in_flight; ++idx)
+    {
+        _regions.add({ idx * _region_bytes });
+    }
+}
+
+size_t TransientAllocator::buffer_bytes(size_t region_bytes, uint32_t frames_in_flight)
+{
+    return align_up(region_bytes, C_REGION_ALIGNMENT) * frames_in_flight;
+}
+
+void TransientAllocator::start_frame(void)
+{
+    _regions.next();
+    _head.store(0, std::memory_order_relaxed);
+}
+
+TransientAllocation TransientAllocator::allocate(TransientUsage usage, size_t bytes)
+{
+    const uint32_t alignment = _alignments[static_cast<size_t>(usage)];
+
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t begin{ 0 };
+
+    do
+    {
+        begin = static_cast<uint32_t>(align_up(head, alignment));
+        if(bytes > _region_bytes || begin > _region_bytes - bytes)
+        {
+            return {};
+        }
+    }
+    while(!_head.compare_exchange_weak(head, begin + static_cast<uint32_t>(bytes), std::memory_order_relaxed));
+
+    const uint32_t offset = _regions.get().begin + begin;
+
+    return { _mapped + offset, &_buffer, offset, static_cast<uint32_t>(bytes) };
+}
+
+GPUBuffer& TransientAllocator::buffer(void) const
+{
+    return _buffer;
+}
+
+uint32_t TransientAllocator::region_bytes(void) const
+{
+    return _region_bytes;
+}
+
+uint32_t TransientAllocator::bytes_used(void) const
+{
+    return _head.load(std::memory_order_relaxed);
+}
@@ -1,9 +1,13 @@
 #include "core/view.h"
 
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
 #include <sstream>
 #include <string>
 
 #include "core/descriptor_set.h"
+#include "core/gpu_buffer.h"
 #include "core/renderer.h"
 
 using namespace rend;
@@ -25,6 +29,12 @@ View::View(const std::string& name, const ViewInfo& info)
         _descriptor_set->bind_resource(descriptor);
     }
 
+    if(_info.constants_bytes > 0)
+    {
+        _descriptor_set->bind_resource({ _info.constants_slot, DescriptorType::UNIFORM_BUFFER_DYNAMIC, &rr.get_transient_buffer(), _info.constants_bytes });
+        _constants.resize(_info.constants_bytes);
+    }
+
     _descriptor_set->write_bindings();
 }
 
@@ -37,3 +47,59 @@ DescriptorSet& View::get_descriptor_set(void)
 {
     return *_descriptor_set;
 }
+
+void View::set_constants(const void* data, size_t bytes)
+{
+    assert(bytes == _constants.size() && "View constants must be the size given in its info");
+    memcpy(_constants.data(), data, std::min(bytes, _constants.size()));
+}
+
+void View::write_constants(void)
+{
+    if(_constants.empty())
+    {
+        return;
+    }
+
+    const TransientAllocation allocation = Renderer::get_instance().allocate_transient(TransientUsage::UNIFORM, _constants.size());
+    assert(allocation.data != nullptr && "Out of transient memory for view constants");
+    if(allocation.data == nullptr)
+    {
+        return;
+    }
+
+    memcpy(allocation.data, _constants.data(), _constants.size());
+    _descriptor_set->set_dynamic_offsets({ allocation.offset });
+}
+
+void View::set_view_projection(const glm::mat4& view_projection)
+{
+    _frustum = make_frustum(view_projection);
+    _has_frustum = true;
+}
+
+const Frustum* View::get_frustum(void) const
+{
+    return _has_frustum ? &_frustum : nullptr;
+}
+
+void View::set_lod_projection(const glm::vec3& eye_position, float projection_scale)
+{
+    _eye_position = eye_position;
+    _projection_scale = projection_scale;
+}
+
+bool View::has_lod_projection(void) const
+{
+    return _projection_scale > 0.0f;
+}
+
+const glm::vec3& View::get_eye_position(void) const
+{
+    return _eye_position;
+}
+
+float View::get_projection_scale(void) const
+{
+    return _projection_scale;
+}